@@ -0,0 +1,148 @@
+#include "batch.h"
+#include "emulator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+
+// Every frame presented this close to a cycle limit is drawn, which always includes the last one.
+// Requests are made at least every half frame so no frame starts without one in front of it
+static const cycle_t FINAL_FRAMES_WINDOW = 2 * Display::FULL_FRAME_TIME;
+static const cycle_t FINAL_FRAMES_STEP   = Display::FULL_FRAME_TIME / 2;
+
+BatchRunner::BatchRunner(const unsigned int threadCount)
+	: _jobs(nullptr)
+	, _results(nullptr)
+	, _nextJob(0)
+	, _pendingJobs(0)
+	, _stopping(false)
+{
+	// No count means one worker per hardware thread
+	unsigned int workers = threadCount != 0 ? threadCount : std::thread::hardware_concurrency();
+	if (workers == 0)
+		workers = 1;
+
+	for (unsigned int i = 0; i < workers; ++i)
+		_workers.emplace_back([this]() { workerLoop(); });
+}
+
+BatchRunner::~BatchRunner()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stopping = true;
+	}
+
+	_jobsAvailable.notify_all();
+
+	for (std::thread& worker: _workers)
+		worker.join();
+}
+
+std::vector<batch_result> BatchRunner::run(const std::vector<batch_job>& jobs)
+{
+	std::vector<batch_result> results(jobs.size());
+	if (jobs.empty())
+		return results;
+
+	// Batches are run one at a time, the call blocks until every job has finished
+	std::unique_lock<std::mutex> lock(_mutex);
+	_jobs        = &jobs;
+	_results     = &results;
+	_nextJob     = 0;
+	_pendingJobs = jobs.size();
+
+	_jobsAvailable.notify_all();
+	_jobsDone.wait(lock, [this]() { return _pendingJobs == 0; });
+
+	_jobs    = nullptr;
+	_results = nullptr;
+	return results;
+}
+
+unsigned int BatchRunner::getThreadCount() const
+{
+	return static_cast<unsigned int>(_workers.size());
+}
+
+void BatchRunner::workerLoop()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+
+	while (true)
+	{
+		_jobsAvailable.wait(lock, [this]() { return _stopping || (_jobs && _nextJob < _jobs->size()); });
+
+		if (_stopping)
+			return;
+
+		const size_t job = _nextJob++;
+
+		lock.unlock();
+		runJob((*_jobs)[job], (*_results)[job]);
+		lock.lock();
+
+		if (--_pendingJobs == 0)
+			_jobsDone.notify_all();
+	}
+}
+
+void BatchRunner::runJob(const batch_job& job, batch_result& result) const
+{
+	result.name      = job.name;
+	result.completed = false;
+	result.frames    = 0;
+	result.cycles    = 0;
+	result.seconds   = 0.0;
+
+	if (job.rom.empty() || (job.frames == 0 && job.cycles == 0))
+		return;
+
+	// Instances are a few hundred KB, too much for the stack of a worker thread on some platforms
+	std::unique_ptr<Emulator> emulator(new Emulator(job.fillDisplayCallback ? job.fillDisplayCallback : [](byte*) {}));
+	emulator->setSkipBios(job.skipBios);
+	emulator->setJitEnabled(job.useJit);
+	emulator->getDisplay().setRenderInterval(job.renderInterval);
+	emulator->loadRom(job.rom);
+
+	if (job.onStart && !job.onStart(*emulator))
+		return;
+
+	const dword startFrame = emulator->getDisplay().getFrameCount();
+	const auto start       = std::chrono::high_resolution_clock::now();
+
+	while ((job.frames == 0 || result.frames < job.frames) &&
+		   (job.cycles == 0 || result.cycles < job.cycles))
+	{
+		if (job.frames != 0)
+		{
+			// Whatever the interval, the frame a job finishes on is always drawn
+			if (result.frames + 1 == job.frames || (job.cycles != 0 && job.cycles - result.cycles <= FINAL_FRAMES_WINDOW))
+				emulator->getDisplay().requestFrame();
+
+			result.cycles += emulator->runFrame();
+		}
+		else
+		{
+			const cycle_t remaining = job.cycles - result.cycles;
+
+			if (remaining > FINAL_FRAMES_WINDOW)
+				result.cycles += emulator->runFor(remaining - FINAL_FRAMES_WINDOW);
+			else
+			{
+				emulator->getDisplay().requestFrame();
+				result.cycles += emulator->runFor(std::min(remaining, FINAL_FRAMES_STEP));
+			}
+		}
+
+		result.frames = emulator->getDisplay().getFrameCount() - startFrame;
+	}
+
+	const auto end = std::chrono::high_resolution_clock::now();
+	result.seconds = std::chrono::duration<double>(end - start).count();
+
+	if (job.onFinish)
+		job.onFinish(*emulator);
+
+	result.completed = true;
+}
\ No newline at end of file
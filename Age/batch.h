@@ -0,0 +1,69 @@
+#pragma once
+
+#include "common.h"
+#include "display.h"
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class Emulator;
+
+struct batch_job
+{
+	std::string       name;
+	std::vector<char> rom;
+	bool              skipBios;
+	bool              useJit;
+
+	// Whichever limit is hit first ends the job, frame limits are honoured at frame granularity
+	unsigned long long frames;
+	cycle_t            cycles;
+
+	// Draw 1 of every N frames, Display::RENDER_ON_REQUEST only draws the last frame a job presents
+	dword renderInterval;
+
+	// Optional hooks, all called on the worker thread that runs the job
+	Display::fill_displays_callback_t fillDisplayCallback;
+	std::function<bool(Emulator&)>    onStart;
+	std::function<void(Emulator&)>    onFinish;
+};
+
+struct batch_result
+{
+	std::string        name;
+	bool               completed;
+	unsigned long long frames;
+	cycle_t            cycles;
+	double             seconds;
+};
+
+// Fixed pool of worker threads running independent emulator instances. Each job builds its own
+// Emulator on the worker that picks it up, so jobs share nothing but their own job description.
+class BatchRunner final
+{
+public:
+	BatchRunner(const unsigned int threadCount = 0);
+	~BatchRunner();
+
+	std::vector<batch_result> run(const std::vector<batch_job>& jobs);
+	unsigned int getThreadCount() const;
+
+private:
+	void workerLoop();
+	void runJob(const batch_job& job, batch_result& result) const;
+
+private:
+	std::vector<std::thread>      _workers;
+	std::mutex                    _mutex;
+	std::condition_variable       _jobsAvailable;
+	std::condition_variable       _jobsDone;
+	const std::vector<batch_job>* _jobs;
+	std::vector<batch_result>*    _results;
+	size_t                        _nextJob;
+	size_t                        _pendingJobs;
+	bool                          _stopping;
+};
\ No newline at end of file
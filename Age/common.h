@@ -4,6 +4,9 @@ using byte    = unsigned char;
 using word    = unsigned short;
 using dword   = unsigned int;
 using timer_t = unsigned long;
+using cycle_t = unsigned long long;
+
+using code_version_t = unsigned long long;
 
 inline int pow2c(dword n)
 {
@@ -1,10 +1,15 @@
 #include "cpu.h"
 #include "memory.h"
+#include "state.h"
 
 #include <iostream>
 #include <unordered_map>
 #include <string>
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 static const byte NO_OPCODE = 0xDD;
 static const word INTERRUPT_HANDLER_VBLANK = 0x0040;
 static const word INTERRUPT_HANDLER_LCD    = 0x0048;
@@ -12,6 +17,80 @@ static const word INTERRUPT_HANDLER_TIMER  = 0x0050;
 static const word INTERRUPT_HANDLER_SLINK  = 0x0058;
 static const word INTERRUPT_HANDLER_JOYPAD = 0x0060;
 
+// Decoded blocks live in a direct mapped cache indexed by start address and tagged with the code version,
+// so neighbouring code never competes for a slot and the same address in another bank simply replaces it
+static const word  BLOCK_CACHE_SIZE = 4096;
+static const dword BLOCK_END        = 0x10000;
+
+// Polling loops are short, anything longer is not worth decoding on every trip round
+static const word MAX_POLLING_LOOP_LENGTH = 32;
+static const word NO_POLLING_LOOP         = 0xFFFF;
+
+// Operation indices as encoded in bits 3-5 of ALU and CB shift opcodes
+static const byte ALU_ADD = 0;
+static const byte ALU_ADC = 1;
+static const byte ALU_SUB = 2;
+static const byte ALU_SBC = 3;
+static const byte ALU_AND = 4;
+static const byte ALU_XOR = 5;
+static const byte ALU_OR  = 6;
+static const byte ALU_CP  = 7;
+
+static const byte SHIFT_RLC  = 0;
+static const byte SHIFT_RRC  = 1;
+static const byte SHIFT_RL   = 2;
+static const byte SHIFT_RR   = 3;
+static const byte SHIFT_SLA  = 4;
+static const byte SHIFT_SRA  = 5;
+static const byte SHIFT_SWAP = 6;
+static const byte SHIFT_SRL  = 7;
+
+// Flag helpers for building F in one go. H is the carry (or borrow) into bit 4, which is bit 4 of
+// a ^ b ^ result, and C is the carry out of bit 7, which lands in bit 8 of the full width result
+static inline byte zeroFlag(const byte result)
+{
+	return static_cast<byte>(result == 0) << 7;
+}
+
+static inline byte carryFlags(const unsigned int a, const unsigned int b, const unsigned int result)
+{
+	return static_cast<byte>((((a ^ b ^ result) & 0x10) << 1) | ((result >> 4) & 0x10));
+}
+
+// DAA outcome for every value of A and every N/H/C combination, indexed by (F & 0x70) << 4 | A
+// and stored as A << 8 | F, so the instruction is a single lookup
+static const word* buildDaaTable()
+{
+	static word table[0x800];
+
+	for (word index = 0; index < 0x800; ++index)
+	{
+		const bool n = (index & 0x400) != 0;
+		const bool h = (index & 0x200) != 0;
+		const bool c = (index & 0x100) != 0;
+		word s = index & 0xFF;
+
+		if (n)
+		{
+			if (h) s = (s - 0x06) & 0xFF;
+			if (c) s -= 0x60;
+		}
+		else
+		{
+			if (h || (s & 0xF) > 9) s += 0x06;
+			if (c || s > 0x9F) s += 0x60;
+		}
+
+		const byte result = s & 0xFF;
+		const byte flags  = zeroFlag(result) | (n ? 0x40 : 0x00) | (c || s >= 0x100 ? 0x10 : 0x00);
+		table[index] = (result << 8) | flags;
+	}
+
+	return table;
+}
+
+static const word* const s_daaTable = buildDaaTable();
+
 static const std::unordered_map<byte, std::string> s_instrDisassembly = 
 {
 	{ 0x00, "NOP" },
@@ -300,6 +379,39 @@ static const byte coreInstructionTicks[256] = {
 	6, 6, 4, 2, 0, 8, 4, 8,  6, 4, 8, 2, 0, 0, 4, 8  // 0xf
 };
 
+// Opcode plus immediate bytes, CB prefixed instructions are all two bytes long
+static const byte coreInstructionLengths[256] = {
+	1, 3, 1, 1, 1, 1, 2, 1, 3, 1, 1, 1, 1, 1, 2, 1, // 0x0
+	2, 3, 1, 1, 1, 1, 2, 1, 2, 1, 1, 1, 1, 1, 2, 1, // 0x1
+	2, 3, 1, 1, 1, 1, 2, 1, 2, 1, 1, 1, 1, 1, 2, 1, // 0x2
+	2, 3, 1, 1, 1, 1, 2, 1, 2, 1, 1, 1, 1, 1, 2, 1, // 0x3
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 0x4
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 0x5
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 0x6
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 0x7
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 0x8
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 0x9
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 0xa
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 0xb
+	1, 1, 3, 3, 3, 1, 2, 1, 1, 1, 3, 2, 3, 3, 2, 1, // 0xc
+	1, 1, 3, 1, 3, 1, 2, 1, 1, 1, 3, 1, 3, 1, 2, 1, // 0xd
+	2, 1, 1, 1, 1, 1, 2, 1, 2, 1, 3, 1, 1, 1, 2, 1, // 0xe
+	2, 1, 1, 1, 1, 1, 2, 1, 2, 1, 3, 1, 1, 1, 2, 1  // 0xf
+};
+
+// Unconditional jumps, calls, returns and HALT/STOP: whatever follows them is not necessarily code
+static inline bool endsBlock(const byte opcode)
+{
+	switch (opcode)
+	{
+		case 0x10: case 0x18: case 0x76: case 0xC3: case 0xC9: case 0xCD: case 0xD9: case 0xE9:
+		case 0xC7: case 0xCF: case 0xD7: case 0xDF: case 0xE7: case 0xEF: case 0xF7: case 0xFF:
+			return true;
+	}
+
+	return false;
+}
+
 static const std::unordered_map<byte, std::string> s_bitOpcodeDisassembly =
 {
 	// Bits
@@ -589,6422 +701,1395 @@ static const byte cbInstructionTicks[256] = {
 };
 
 Cpu::Cpu(Memory& memory)
-	: _memory(memory)
+	: _blocks(BLOCK_CACHE_SIZE)
+	, _raisedInterrupts(memory.getRaisedInterruptsPtr())
 	, _opcode(NO_OPCODE)
 	, _isBitOpcode(false)
+	, _memory(memory)
 {
 	resetCpu();
+
+	// Bank switches and writes to cached RAM code take effect from the very next instruction
+	_memory.setCodeChangedCallback([this]() { _nextOp = &s_blockEnd; });
 }
 
-void Cpu::emulateCycle()
+// Immediates are decoded along with the opcode, handlers take them a byte at a time stepping pc over them
+byte Cpu::immediateByte()
 {
-	if (_halted)
-		return;
-	
-	_opcode      = _memory.readByte(_registers.pc++);
-	_isBitOpcode = false;
+	const byte val = static_cast<byte>(_immediate);
+	_immediate >>= 8;
+	++_registers.pc;
+	return val;
+}
+
+template<> byte Cpu::readOperand<0>() { return _registers.B; }
+template<> byte Cpu::readOperand<1>() { return _registers.C; }
+template<> byte Cpu::readOperand<2>() { return _registers.D; }
+template<> byte Cpu::readOperand<3>() { return _registers.E; }
+template<> byte Cpu::readOperand<4>() { return _registers.H; }
+template<> byte Cpu::readOperand<5>() { return _registers.L; }
+template<> byte Cpu::readOperand<6>() { return _memory.readByte((_registers.H << 8) + _registers.L); }
+template<> byte Cpu::readOperand<7>() { return _registers.A; }
+
+template<> void Cpu::writeOperand<0>(const byte val) { _registers.B = val; }
+template<> void Cpu::writeOperand<1>(const byte val) { _registers.C = val; }
+template<> void Cpu::writeOperand<2>(const byte val) { _registers.D = val; }
+template<> void Cpu::writeOperand<3>(const byte val) { _registers.E = val; }
+template<> void Cpu::writeOperand<4>(const byte val) { _registers.H = val; }
+template<> void Cpu::writeOperand<5>(const byte val) { _registers.L = val; }
+template<> void Cpu::writeOperand<6>(const byte val) { _memory.writeByte((_registers.H << 8) + _registers.L, val); }
+template<> void Cpu::writeOperand<7>(const byte val) { _registers.A = val; }
+
+template<byte operation>
+void Cpu::executeAluOperation(const byte val)
+{
+	const unsigned int a     = _registers.A;
+	const unsigned int carry = (operation == ALU_ADC || operation == ALU_SBC) ? getFlag(FLAG_C) : 0;
 
-	switch (_opcode)
+	switch (operation)
 	{
-		
-		case 0x00: // NOP
+		case ALU_ADD:
+		case ALU_ADC:
 		{
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
+			const unsigned int result = a + val + carry;
 
-		// 8 Bit Loads
-		case 0x06: // LD B,n
-		{
-			_registers.B = _memory.readByte(_registers.pc++);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x0E: // LD C,n
-		{
-			_registers.C = _memory.readByte(_registers.pc++);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x16: // LD D,n
-		{
-			_registers.D = _memory.readByte(_registers.pc++);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x1E: // LD E,n
-		{
-			_registers.E = _memory.readByte(_registers.pc++);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x26: // LD H,n
-		{
-			_registers.H = _memory.readByte(_registers.pc++);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x2E: // LD L,n
-		{
-			_registers.L = _memory.readByte(_registers.pc++);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x7F: // LD A, A
-		{
-			_registers.A = _registers.A;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x78: // LD A, B
-		{
-			_registers.A = _registers.B;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x79: // LD A, C
-		{
-			_registers.A = _registers.C;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x7A: // LD A, D
-		{
-			_registers.A = _registers.D;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x7B: // LD A, E
-		{
-			_registers.A = _registers.E;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x7C: //LD A, H
-		{
-			_registers.A = _registers.H;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x7D: // LD A, L
-		{
-			_registers.A = _registers.L;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xF2: // LD A, (C)
-		{
-			_registers.A = _memory.readByte(0xFF00 + _registers.C);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x7E: // LD A, (HL)
-		{
-			_registers.A = _memory.readByte((_registers.H << 8) + _registers.L);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x0A: // LD A, (BC)
-		{
-			_registers.A = _memory.readByte((_registers.B << 8) + _registers.C);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x1A: // LD A, (DE)
-		{
-			_registers.A = _memory.readByte((_registers.D << 8) + _registers.E);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xFA: // LD A, (nn)
-		{
-			word address = _memory.readWord(_registers.pc);
-			_registers.pc += 2;
-			_registers.A = _memory.readByte(address);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x47: // LD B, A
-		{
-			_registers.B = _registers.A;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x40: // LD B, B
-		{
-			_registers.B = _registers.B;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x41: // LD B, C
-		{
-			_registers.B = _registers.C;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x42: // LD B, D
-		{
-			_registers.B = _registers.D;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x43: // LD B, E
-		{
-			_registers.B = _registers.E;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x44: // LD B, H
-		{
-			_registers.B = _registers.H;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x45: // LD B, L
-		{
-			_registers.B = _registers.L;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x46: // LD B, (HL)
-		{
-			_registers.B = _memory.readByte((_registers.H << 8) + _registers.L);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x4F: // LD C, A
-		{
-			_registers.C = _registers.A;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x48: // LD C, B
-		{
-			_registers.C = _registers.B;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x49: // LD C, C
-		{
-			_registers.C = _registers.C;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x4A: // LD C, D
-		{
-			_registers.C = _registers.D;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x4B: // LD C, E
-		{
-			_registers.C = _registers.E;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x4C: // LD C, H
-		{
-			_registers.C = _registers.H;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x4D: // LD C, L
-		{
-			_registers.C = _registers.L;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x4E: // LD C, (HL)
-		{
-			_registers.C = _memory.readByte((_registers.H << 8) + _registers.L);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x57: // LD D, A
-		{
-			_registers.D = _registers.A;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x50: // LD D, B
-		{
-			_registers.D = _registers.B;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x51: // LD D, C
-		{
-			_registers.D = _registers.C;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x52: // LD D, D
-		{
-			_registers.D = _registers.D;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x53: // LD D, E
-		{
-			_registers.D = _registers.E;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x54: // LD D, H
-		{
-			_registers.D = _registers.H;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x55: // LD D, L
-		{
-			_registers.D = _registers.L;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x56: // LD D, (HL)
-		{
-			_registers.D = _memory.readByte((_registers.H << 8) + _registers.L);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x5F: // LD E, A
-		{
-			_registers.E = _registers.A;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x58: // LD E, B
-		{
-			_registers.E = _registers.B;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x59: // LD E, C
-		{
-			_registers.E = _registers.C;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x5A: // LD E, D
-		{
-			_registers.E = _registers.D;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
+			_registers.A = static_cast<byte>(result);
+			_registers.F = zeroFlag(_registers.A) | carryFlags(a, val, result);
 		} break;
-		case 0x5B: // LD E, E
-		{
-			_registers.E = _registers.E;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x5C: // LD E, H
-		{
-			_registers.E = _registers.H;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x5D: // LD E, L
-		{
-			_registers.E = _registers.L;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x5E: // LD E, (HL)
-		{
-			_registers.E = _memory.readByte((_registers.H << 8) + _registers.L);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x66: // LD H, (HL)
-		{
-			_registers.H = _memory.readByte((_registers.H << 8) + _registers.L);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x67: // LD H, A
-		{
-			_registers.H = _registers.A;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x60: // LD H, B
-		{
-			_registers.H = _registers.B;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x61: // LD H, C
-		{
-			_registers.H = _registers.C;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x62: // LD H, D
-		{
-			_registers.H = _registers.D;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x63: // LD H, E
-		{
-			_registers.H = _registers.E;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x64: // LD H, H
-		{
-			_registers.H = _registers.H;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x65: // LD H, L
-		{
-			_registers.H = _registers.L;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x6F: // LD L, A
-		{
-			_registers.L = _registers.A;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x68: // LD L, B
-		{
-			_registers.L = _registers.B;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x69: // LD L, C
-		{
-			_registers.L = _registers.C;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x6A: // LD L, D
-		{
-			_registers.L = _registers.D;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x6B: // LD L, E
-		{
-			_registers.L = _registers.E;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x6C: // LD L, H
-		{
-			_registers.L = _registers.H;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x6D: // LD L, L
-		{
-			_registers.L = _registers.L;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x6E: // LD L, (HL)
-		{
-			_registers.L = _memory.readByte((_registers.H << 8) + _registers.L);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x77: // LD (HL), A
-		{
-			_memory.writeByte(((_registers.H << 8) + _registers.L), _registers.A);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xF8: // LDHL SP, n
-		{
-			signed char val = _memory.readByte(_registers.pc++);
-			int result = _registers.sp + val;
-			
-			// Gearboy saves the day again
-			if (((_registers.sp ^ val ^ result) & 0x100) == 0x100)
-				setFlag(FLAG_C);
-			else
-				resetFlag(FLAG_C);
-
-			if (((_registers.sp ^ val ^ result) & 0x10) == 0x10)
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			resetFlag(FLAG_Z);
-			resetFlag(FLAG_N);
-			
-			_registers.H = ((result & 0xFF00) >> 8);
-			_registers.L = result & 0x00FF;
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x70: // LD (HL), B
-		{
-			_memory.writeByte(((_registers.H << 8) + _registers.L), _registers.B);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x71: // LD (HL), C
-		{
-			_memory.writeByte(((_registers.H << 8) + _registers.L), _registers.C);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x72: // LD (HL), D
-		{
-			_memory.writeByte(((_registers.H << 8) + _registers.L), _registers.D);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x73: // LD (HL), E
-		{
-			_memory.writeByte(((_registers.H << 8) + _registers.L), _registers.E);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x74: // LD (HL), H
-		{
-			_memory.writeByte(((_registers.H << 8) + _registers.L), _registers.H);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x75: // LD (HL), L
-		{
-			_memory.writeByte(((_registers.H << 8) + _registers.L), _registers.L);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x3E: // LD A, #
-		{
-			_registers.A = _memory.readByte(_registers.pc++);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xE0: // LDH (n), A
-		{
-			byte address = _memory.readByte(_registers.pc++);
-			_memory.writeByte(0xFF00 + address, _registers.A);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xE2: // LD (C), A
-		{			
-			_memory.writeByte(0xFF00 + _registers.C, _registers.A);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xF0: // LDH A,(n)
-		{
-			word address = _memory.readByte(_registers.pc++) + 0xFF00;
-			_registers.A = _memory.readByte(address);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x22: // LDI (HL), A
-		{
-			_memory.writeByte((_registers.H << 8) + _registers.L, _registers.A);
-			if (_registers.L == 0xFF)
-				_registers.H++;
-			_registers.L++;
-			
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x2A: // LDI A, (HL)
-		{
-			_registers.A = _memory.readByte((_registers.H << 8) + _registers.L);
-			if (_registers.L == 0xFF)
-				_registers.H++;
-			_registers.L++;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x3A: // LDD A, (HL)
-		{
-			_registers.A = _memory.readByte((_registers.H << 8) + _registers.L);
-			_registers.L--;
-			if (_registers.L == 0xFF)
-				_registers.H--;
 
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x02: // LD (BC) A
-		{
-			_memory.writeByte((_registers.B << 8) + _registers.C, _registers.A);			
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x12: // LD (DE) A
-		{
-			_memory.writeByte((_registers.D << 8) + _registers.E, _registers.A);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xEA: // LD (nn), A
-		{
-			word address = _memory.readWord(_registers.pc);
-			_registers.pc += 2;
-			_memory.writeByte(address, _registers.A);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x36: // LD (HL), n
+		case ALU_SUB:
+		case ALU_SBC:
+		case ALU_CP:
 		{
-			byte nextByte = _memory.readByte(_registers.pc++);
-			_memory.writeByte((_registers.H << 8) + _registers.L, nextByte);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
+			// Borrows wrap the unsigned result around, which sets bit 8 just like a carry would
+			const unsigned int result = a - val - carry;
 
-		// 16 Bit Loads
-		case 0x08: // LD nn,sp
-		{
-			word address = _memory.readWord(_registers.pc);
-			_registers.pc += 2;
-			_memory.writeWord(address, _registers.sp);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;			
-		} break;
-		case 0xF9: // LD sp, HL
-		{
-			_registers.sp = (_registers.H << 8) + _registers.L;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x01: // LD BC, nn
-		{
-			_registers.C = _memory.readByte(_registers.pc++);
-			_registers.B = _memory.readByte(_registers.pc++);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x11: // LD DE, nn
-		{
-			_registers.E = _memory.readByte(_registers.pc++);
-			_registers.D = _memory.readByte(_registers.pc++);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x21: // LD HL,nn
-		{
-			_registers.L = _memory.readByte(_registers.pc++);
-			_registers.H = _memory.readByte(_registers.pc++);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x31: // LD SP,nn
-		{
-			_registers.sp = _memory.readWord(_registers.pc);
-			_registers.pc += 2;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x32: // LDD (HL), A 
-		{
-			_memory.writeByte((_registers.H << 8) + _registers.L, _registers.A);
-			_registers.L--;
-			if (_registers.L == 0xFF)
-				_registers.H--;
+			if (operation != ALU_CP)
+				_registers.A = static_cast<byte>(result);
 
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
+			_registers.F = zeroFlag(static_cast<byte>(result)) | FLAG_N | carryFlags(a, val, result);
 		} break;
-		case 0xF5: // PUSH AF
-		{
-			_memory.writeByte(--_registers.sp, _registers.A);
-			_memory.writeByte(--_registers.sp, _registers.F);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
 
-		} break;
-		case 0xC5: // PUSH BC
-		{
-			_memory.writeByte(--_registers.sp, _registers.B);
-			_memory.writeByte(--_registers.sp, _registers.C);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xD5: // PUSH DE
-		{
-			_memory.writeByte(--_registers.sp, _registers.D);
-			_memory.writeByte(--_registers.sp, _registers.E);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xE5: // PUSH HL
-		{
-			_memory.writeByte(--_registers.sp, _registers.H);
-			_memory.writeByte(--_registers.sp, _registers.L);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xF1: // POP AF
-		{
-			_registers.F = (_memory.readByte(_registers.sp++) & 0xF0);
-			_registers.A = _memory.readByte(_registers.sp++);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xC1: // POP BC
-		{
-			_registers.C = _memory.readByte(_registers.sp++);
-			_registers.B = _memory.readByte(_registers.sp++);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xD1: // POP DE
+		case ALU_AND:
 		{
-			_registers.E = _memory.readByte(_registers.sp++);
-			_registers.D = _memory.readByte(_registers.sp++);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
+			_registers.A &= val;
+			_registers.F = zeroFlag(_registers.A) | FLAG_H;
 		} break;
-		case 0xE1: // POP HL
+
+		case ALU_XOR:
 		{
-			_registers.L = _memory.readByte(_registers.sp++);
-			_registers.H = _memory.readByte(_registers.sp++);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
+			_registers.A ^= val;
+			_registers.F = zeroFlag(_registers.A);
 		} break;
 
-		// 8-bit ALU
-		case 0x3C: // INC A
+		case ALU_OR:
 		{
-			if ((_registers.A & 0x0F) == 0x0F)
-				setFlag(FLAG_H);
-			else 
-				resetFlag(FLAG_H);
-			resetFlag(FLAG_N);
-
-			_registers.A++;
-
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
+			_registers.A |= val;
+			_registers.F = zeroFlag(_registers.A);
 		} break;
-		case 0x04: // INC B
-		{
-			if ((_registers.B & 0x0F) == 0x0F)
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-			resetFlag(FLAG_N);
-
-			_registers.B++;
+	}
+}
 
-			if (_registers.B == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
+template<byte operation>
+byte Cpu::executeShiftOperation(const byte val)
+{
+	// Left shifts carry out of bit 7 and right shifts out of bit 0, both moved into FLAG_C
+	const byte carryLeft  = (val & 0x80) >> 3;
+	const byte carryRight = (val & 0x01) << 4;
 
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x0C: // INC C
-		{
-			if ((_registers.C & 0x0F) == 0x0F)
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-			resetFlag(FLAG_N);
+	byte result = 0;
+	byte carry  = 0;
 
-			_registers.C++;
+	switch (operation)
+	{
+		case SHIFT_RLC:  result = (val << 1) | (val >> 7);                 carry = carryLeft;  break;
+		case SHIFT_RRC:  result = (val >> 1) | (val << 7);                 carry = carryRight; break;
+		case SHIFT_RL:   result = (val << 1) | getFlag(FLAG_C);            carry = carryLeft;  break;
+		case SHIFT_RR:   result = (val >> 1) | (getFlag(FLAG_C) << 7);     carry = carryRight; break;
+		case SHIFT_SLA:  result = val << 1;                                carry = carryLeft;  break;
+		case SHIFT_SRA:  result = (val >> 1) | (val & 0x80);               carry = carryRight; break;
+		case SHIFT_SWAP: result = ((val & 0x0F) << 4 | (val & 0xF0) >> 4); carry = 0;          break;
+		case SHIFT_SRL:  result = val >> 1;                                carry = carryRight; break;
+	}
 
-			if (_registers.C == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
+	_registers.F = zeroFlag(result) | carry;
+	return result;
+}
 
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x14: // INC D
-		{
-			if ((_registers.D & 0x0F) == 0x0F)
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-			resetFlag(FLAG_N);
+// Register variant families (LD r, r' / ALU A, r / INC r / DEC r / LD r, n) are
+// decoded from the opcode bits at compile time. Everything else is specialized below.
+template<byte opcode>
+void Cpu::executeCoreOpcode()
+{
+	const byte dst = (opcode >> 3) & 7;
+	const byte src = opcode & 7;
 
-			_registers.D++;
+	if (opcode >= 0x40 && opcode <= 0x7F) // LD r, r'
+	{
+		writeOperand<dst>(readOperand<src>());
+	}
+	else if (opcode >= 0x80 && opcode <= 0xBF) // ALU A, r
+	{
+		executeAluOperation<dst>(readOperand<src>());
+	}
+	else if ((opcode & 0xC7) == 0xC6) // ALU A, n
+	{
+		executeAluOperation<dst>(immediateByte());
+	}
+	else if ((opcode & 0xC7) == 0x04) // INC r
+	{
+		// C is left alone, H is set when the low nibble wraps to 0
+		const byte val = readOperand<dst>() + 1;
+		writeOperand<dst>(val);
 
-			if (_registers.D == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
+		_registers.F = (_registers.F & FLAG_C) | zeroFlag(val) | (static_cast<byte>((val & 0x0F) == 0x00) << 5);
+	}
+	else if ((opcode & 0xC7) == 0x05) // DEC r
+	{
+		// C is left alone, H is set when the low nibble wraps to F
+		const byte val = readOperand<dst>() - 1;
+		writeOperand<dst>(val);
 
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x1C: // INC E
-		{
-			if ((_registers.E & 0x0F) == 0x0F)
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-			resetFlag(FLAG_N);
-
-			_registers.E++;
-
-			if (_registers.E == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x24: // INC H
-		{
-			if ((_registers.H & 0x0F) == 0x0F)
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-			resetFlag(FLAG_N);
-
-			_registers.H++;
-
-			if (_registers.H == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x2C: // INC L
-		{
-			if ((_registers.L & 0x0F) == 0x0F)
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-			resetFlag(FLAG_N);
-
-			_registers.L++;
-
-			if (_registers.L == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x34: // INC (HL)
-		{
-			byte nextByte = _memory.readByte((_registers.H << 8) + _registers.L) + 1;
-			_memory.writeByte((_registers.H << 8) + _registers.L, nextByte);
-
-			if ((nextByte & 0x0F) == 0x00)
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			resetFlag(FLAG_N);
-
-			if (nextByte == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x3D: // DEC A
-		{
-			if ((_registers.A & 0x0F) == 0x00)
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			_registers.A--;
-			if (_registers.A == 0) 
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-
-			setFlag(FLAG_N);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x05: // DEC B
-		{
-			if ((_registers.B & 0x0F) == 0x0)
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			_registers.B--;
-			if (_registers.B == 0)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-
-			setFlag(FLAG_N);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x0D: // DEC C
-		{
-			if ((_registers.C & 0x0F) == 0x0)
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			_registers.C--;
-			if (_registers.C == 0)
-				setFlag(FLAG_Z);
-			else 
-				resetFlag(FLAG_Z);
-			setFlag(FLAG_N);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x15: // DEC D
-		{
-			if ((_registers.D & 0x0F) == 0x0)
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			_registers.D--;
-			if (_registers.D == 0)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-			setFlag(FLAG_N);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x1D: // DEC E
-		{
-			if ((_registers.E & 0x0F) == 0x0)
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			_registers.E--;
-			if (_registers.E == 0)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-			setFlag(FLAG_N);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-
-		case 0x25: // DEC H
-		{
-			if ((_registers.H & 0x0F) == 0x0)
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			_registers.H--;
-			if (_registers.H == 0)
-				setFlag(FLAG_Z);
-			else 
-				resetFlag(FLAG_Z);
-			setFlag(FLAG_N);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x2D: // DEC L
-		{
-			if ((_registers.L & 0x0F) == 0x0)
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			_registers.L--;
-			if (_registers.L == 0)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-			setFlag(FLAG_N);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x35: // DEC HL
-		{
-			byte nextByte = _memory.readByte((_registers.H << 8) + _registers.L);
-			
-			if ((nextByte & 0x0F) == 0x0)
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-			
-			_memory.writeByte((_registers.H << 8) + _registers.L, --nextByte);
-
-			if (nextByte == 0)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-
-			setFlag(FLAG_N);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x87: // ADD A, A
-		{
-			if (0xFF - _registers.A < _registers.A)
-				setFlag(FLAG_C);
-			else
-				resetFlag(FLAG_C);
-
-			if (0x0F - (_registers.A & 0x0F) < (_registers.A & 0x0F))
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			_registers.A += _registers.A;
-
-			resetFlag(FLAG_N);
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x80: // ADD A, B
-		{
-			if (0xFF - _registers.A < _registers.B)
-				setFlag(FLAG_C);
-			else
-				resetFlag(FLAG_C);
-
-			if (0x0F - (_registers.A & 0x0F) < (_registers.B & 0x0F))
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			_registers.A += _registers.B;
-			
-			resetFlag(FLAG_N);
-
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x81: // ADD A, C
-		{
-			if (0xFF - _registers.A < _registers.C)
-				setFlag(FLAG_C);
-			else
-				resetFlag(FLAG_C);
-
-			if (0x0F - (_registers.A & 0x0F) < (_registers.C & 0x0F))
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			resetFlag(FLAG_N);
-			_registers.A += _registers.C;
-
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x82: // ADD A, D
-		{
-			if (0xFF - _registers.A < _registers.D)
-				setFlag(FLAG_C);
-			else
-				resetFlag(FLAG_C);
-
-			if (0x0F - (_registers.A & 0x0F) < (_registers.D & 0x0F))
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			resetFlag(FLAG_N);
-			_registers.A += _registers.D;
-
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x83: // ADD A, E
-		{
-			if (0xFF - _registers.A < _registers.E)
-				setFlag(FLAG_C);
-			else
-				resetFlag(FLAG_C);
-
-			if (0x0F - (_registers.A & 0x0F) < (_registers.E & 0x0F))
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			resetFlag(FLAG_N);
-
-			_registers.A += _registers.E;
-
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x84: // ADD A, H
-		{
-			if (0xFF - _registers.A < _registers.H)
-				setFlag(FLAG_C);
-			else
-				resetFlag(FLAG_C);
-
-			if (0x0F - (_registers.A & 0x0F) < (_registers.H & 0x0F))
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			resetFlag(FLAG_N);
-			_registers.A += _registers.H;
-
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x85: // ADD A, L
-		{
-			if (0xFF - _registers.A < _registers.L)
-				setFlag(FLAG_C);
-			else
-				resetFlag(FLAG_C);
-
-			if (0x0F - (_registers.A & 0x0F) < (_registers.L & 0x0F))
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			resetFlag(FLAG_N);
-
-			_registers.A += _registers.L;
-
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x86: // ADD A, HL
-		{
-			byte val = _memory.readByte((_registers.H << 8) + _registers.L);
-			if (0xFF - _registers.A < val)
-				setFlag(FLAG_C);
-			else
-				resetFlag(FLAG_C);
-
-			if (0x0F - (_registers.A & 0x0F) < (val & 0x0F))
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			resetFlag(FLAG_N);
-			
-			_registers.A += val;
-
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xC6: // ADD A, #
-		{
-			byte val = _memory.readByte(_registers.pc++);
-			if (0xFF - _registers.A < val)
-				setFlag(FLAG_C);
-			else
-				resetFlag(FLAG_C);
-
-			if (0x0F - (_registers.A & 0x0F) < (val & 0x0F))
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			resetFlag(FLAG_N);
-
-			_registers.A += val;
-
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xA7: // AND A, A
-		{
-			_registers.A = _registers.A & _registers.A;
-
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-			resetFlag(FLAG_N);
-			setFlag(FLAG_H);
-			resetFlag(FLAG_C);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xA0: // AND A, B
-		{
-			_registers.A = _registers.A & _registers.B;
-
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-			resetFlag(FLAG_N);
-			setFlag(FLAG_H);
-			resetFlag(FLAG_C);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xA1: // AND A, C
-		{
-			_registers.A = _registers.A & _registers.C;
-
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-			resetFlag(FLAG_N);
-			setFlag(FLAG_H);
-			resetFlag(FLAG_C);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xA2: // AND A, D
-		{
-			_registers.A = _registers.A & _registers.D;
-
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-			resetFlag(FLAG_N);
-			setFlag(FLAG_H);
-			resetFlag(FLAG_C);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xA3: // AND A, E
-		{
-			_registers.A = _registers.A & _registers.E;
-
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-			resetFlag(FLAG_N);
-			setFlag(FLAG_H);
-			resetFlag(FLAG_C);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xA4: // AND A, H
-		{
-			_registers.A = _registers.A & _registers.H;
-
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-			resetFlag(FLAG_N);
-			setFlag(FLAG_H);
-			resetFlag(FLAG_C);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xA5: // AND A, L
-		{
-			_registers.A = _registers.A & _registers.L;
-
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-			resetFlag(FLAG_N);
-			setFlag(FLAG_H);
-			resetFlag(FLAG_C);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xA6: // AND A, (HL)
-		{
-			_registers.A = _registers.A & _memory.readByte((_registers.H << 8) + _registers.L);
-
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-			resetFlag(FLAG_N);
-			setFlag(FLAG_H);
-			resetFlag(FLAG_C);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xE6: // AND A, #
-		{
-			_registers.A = _registers.A & _memory.readByte(_registers.pc++);
-		
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-			resetFlag(FLAG_N);
-			setFlag(FLAG_H);
-			resetFlag(FLAG_C);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x97: // SUB A
-		{
-			if ((_registers.A & 0x0F) < (_registers.A & 0x0F))
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-			
-			if (_registers.A < _registers.A)
-				setFlag(FLAG_C);
-			else
-				resetFlag(FLAG_C);
-
-			_registers.A -= _registers.A;
-
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-			setFlag(FLAG_N);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x90: // SUB B
-		{
-			if ((_registers.A & 0x0F) < (_registers.B & 0x0F))
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			if (_registers.A < _registers.B)
-				setFlag(FLAG_C);
-			else
-				resetFlag(FLAG_C);
-
-			_registers.A -= _registers.B;
-
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-			setFlag(FLAG_N);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x91: // SUB C
-		{
-			if ((_registers.A & 0x0F) < (_registers.C & 0x0F))
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			if (_registers.A < _registers.C)
-				setFlag(FLAG_C);
-			else
-				resetFlag(FLAG_C);
-
-			_registers.A -= _registers.C;
-
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-			setFlag(FLAG_N);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x92: // SUB D
-		{
-			if ((_registers.A & 0x0F) < (_registers.D & 0x0F))
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			if (_registers.A < _registers.D)
-				setFlag(FLAG_C);
-			else
-				resetFlag(FLAG_C);
-
-			_registers.A -= _registers.D;
-
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-			setFlag(FLAG_N);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x93: // SUB E
-		{
-			if ((_registers.A & 0x0F) < (_registers.E & 0x0F))
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			if (_registers.A < _registers.E)
-				setFlag(FLAG_C);
-			else
-				resetFlag(FLAG_C);
-
-			_registers.A -= _registers.E;
-
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-			setFlag(FLAG_N);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x94: // SUB H
-		{
-			if ((_registers.A & 0x0F) < (_registers.H & 0x0F))
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			if (_registers.A < _registers.H)
-				setFlag(FLAG_C);
-			else
-				resetFlag(FLAG_C);
-
-			_registers.A -= _registers.H;
-
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-			setFlag(FLAG_N);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x95: // SUB L
-		{
-			if ((_registers.A & 0x0F) < (_registers.L & 0x0F))
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			if (_registers.A < _registers.L)
-				setFlag(FLAG_C);
-			else
-				resetFlag(FLAG_C);
-
-			_registers.A -= _registers.L;
-
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-			setFlag(FLAG_N);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x96: // SUB (HL)
-		{
-			byte nextByte = _memory.readByte((_registers.H << 8) + _registers.L);
-			if ((_registers.A & 0x0F) < (nextByte & 0x0F))
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			if (_registers.A < nextByte)
-				setFlag(FLAG_C);
-			else
-				resetFlag(FLAG_C);
-
-			_registers.A -= nextByte;
-
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-			setFlag(FLAG_N);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xD6: // SUB #
-		{
-			byte nextByte = _memory.readByte(_registers.pc++);
-			if ((_registers.A & 0x0F) < (nextByte & 0x0F))
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			if (_registers.A < nextByte)
-				setFlag(FLAG_C);
-			else
-				resetFlag(FLAG_C);
-
-			_registers.A -= nextByte;
-
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-			setFlag(FLAG_N);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xBF: // CP A, A
-		{
-			if (_registers.A - _registers.A == 0)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-
-			setFlag(FLAG_N);
-
-			if (_registers.A < _registers.A)
-				setFlag(FLAG_C);
-			else
-				resetFlag(FLAG_C);
-
-			if ((_registers.A & 0x0F) < (_registers.A & 0x0F))
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xB8: // CP A, B
-		{
-			if (_registers.A - _registers.B == 0)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-
-			setFlag(FLAG_N);
-
-			if (_registers.A < _registers.B)
-				setFlag(FLAG_C);
-			else
-				resetFlag(FLAG_C);
-
-			if ((_registers.A & 0x0F) < (_registers.B & 0x0F))
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xB9: //CP A, C
-		{
-			if (_registers.A - _registers.C == 0)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-
-			setFlag(FLAG_N);
-
-			if (_registers.A < _registers.C)
-				setFlag(FLAG_C);
-			else
-				resetFlag(FLAG_C);
-
-			if ((_registers.A & 0x0F) < (_registers.C & 0x0F))
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xBA: // CP A, D
-		{
-			if (_registers.A - _registers.D == 0)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-
-			setFlag(FLAG_N);
-
-			if (_registers.A < _registers.D)
-				setFlag(FLAG_C);
-			else
-				resetFlag(FLAG_C);
-
-			if ((_registers.A & 0x0F) < (_registers.D & 0x0F))
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xBB: //CP A, E
-		{
-			if (_registers.A - _registers.E == 0)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-
-			setFlag(FLAG_N);
-
-			if (_registers.A < _registers.E)
-				setFlag(FLAG_C);
-			else
-				resetFlag(FLAG_C);
-
-			if ((_registers.A & 0x0F) < (_registers.E & 0x0F))
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xBC: //CP A, H
-		{
-			if (_registers.A - _registers.H == 0)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-
-			setFlag(FLAG_N);
-
-			if (_registers.A < _registers.H)
-				setFlag(FLAG_C);
-			else
-				resetFlag(FLAG_C);
-
-			if ((_registers.A & 0x0F) < (_registers.H & 0x0F))
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xBD: // CP A, L
-		{
-			if (_registers.A - _registers.L == 0)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-
-			setFlag(FLAG_N);
-
-			if (_registers.A < _registers.L)
-				setFlag(FLAG_C);
-			else
-				resetFlag(FLAG_C);
-
-			if ((_registers.A & 0x0F) < (_registers.L & 0x0F))
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xFE: // CP A, #
-		{
-			byte val = _memory.readByte(_registers.pc++);
-
-			if (_registers.A - val == 0)
-				setFlag(FLAG_Z);
-			else 
-				resetFlag(FLAG_Z);
-
-			setFlag(FLAG_N);
-
-			if (_registers.A < val)
-				setFlag(FLAG_C);
-			else
-				resetFlag(FLAG_C);
-
-			if ((_registers.A & 0x0F) < (val & 0x0F))
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xBE: // CP A, HL
-		{
-			byte val = _memory.readByte((_registers.H << 8) + _registers.L);
-			if (_registers.A - val == 0)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-
-			setFlag(FLAG_N);
-
-			if (_registers.A < val)
-				setFlag(FLAG_C);
-			else
-				resetFlag(FLAG_C);
-
-			if ((_registers.A & 0x0F) < (val & 0x0F))
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xB7: // OR A, A
-		{
-			_registers.A = _registers.A | _registers.A;
-
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-			resetFlag(FLAG_H);
-			resetFlag(FLAG_N);
-			resetFlag(FLAG_C);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xB0: // OR A, B
-		{
-			_registers.A = _registers.A | _registers.B;
-
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-			resetFlag(FLAG_H);
-			resetFlag(FLAG_N);
-			resetFlag(FLAG_C);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xB1: // OR A, C
-		{
-			_registers.A = _registers.A | _registers.C;
-
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-			resetFlag(FLAG_H);
-			resetFlag(FLAG_N);
-			resetFlag(FLAG_C);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xB2: // OR A, D
-		{
-			_registers.A = _registers.A | _registers.D;
-
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-			resetFlag(FLAG_H);
-			resetFlag(FLAG_N);
-			resetFlag(FLAG_C);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xB3: // OR A, E
-		{
-			_registers.A = _registers.A | _registers.E;
-
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-			resetFlag(FLAG_H);
-			resetFlag(FLAG_N);
-			resetFlag(FLAG_C);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xB4: // OR A, H
-		{
-			_registers.A = _registers.A | _registers.H;
-
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-			resetFlag(FLAG_H);
-			resetFlag(FLAG_N);
-			resetFlag(FLAG_C);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xB5: // OR A, L
-		{
-			_registers.A = _registers.A | _registers.L;
-
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-			resetFlag(FLAG_H);
-			resetFlag(FLAG_N);
-			resetFlag(FLAG_C);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xB6: // OR A, (HL)
-		{
-			_registers.A = _registers.A | _memory.readByte((_registers.H << 8) + _registers.L);
-
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-			resetFlag(FLAG_H);
-			resetFlag(FLAG_N);
-			resetFlag(FLAG_C);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xF6: // OR A, #
-		{
-			_registers.A = _registers.A | _memory.readByte(_registers.pc++);
-
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-			resetFlag(FLAG_H);
-			resetFlag(FLAG_N);
-			resetFlag(FLAG_C);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xAF: // XOR A, A
-		{
-			_registers.A ^= _registers.A; 
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z); 
-			else
-				resetFlag(FLAG_Z);
-			resetFlag(FLAG_N);
-			resetFlag(FLAG_H);
-			resetFlag(FLAG_C);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xA8: // XOR A, B
-		{
-			_registers.A ^= _registers.B;
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z); 
-			else
-				resetFlag(FLAG_Z);
-			resetFlag(FLAG_N);
-			resetFlag(FLAG_H);
-			resetFlag(FLAG_C);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xA9: // XOR A, C
-		{
-			_registers.A ^= _registers.C;
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z); 
-			else
-				resetFlag(FLAG_Z);
-			resetFlag(FLAG_N);
-			resetFlag(FLAG_H);
-			resetFlag(FLAG_C);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xAA: // XOR A, D
-		{
-			_registers.A ^= _registers.D;
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z); 
-			else
-				resetFlag(FLAG_Z);
-			resetFlag(FLAG_N);
-			resetFlag(FLAG_H);
-			resetFlag(FLAG_C);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xAB: // XOR A, E
-		{
-			_registers.A ^= _registers.E;
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z); 
-			else
-				resetFlag(FLAG_Z);
-			resetFlag(FLAG_N);
-			resetFlag(FLAG_H);
-			resetFlag(FLAG_C);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xAC: // XOR A, H
-		{
-			_registers.A ^= _registers.H; 
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z); 
-			else
-				resetFlag(FLAG_Z);
-			resetFlag(FLAG_N);
-			resetFlag(FLAG_H);
-			resetFlag(FLAG_C);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xAD: // XOR A, L
-		{
-			_registers.A ^= _registers.L;
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z); 
-			else
-				resetFlag(FLAG_Z);
-			resetFlag(FLAG_N);
-			resetFlag(FLAG_H);
-			resetFlag(FLAG_C);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xAE: // XOR A, (HL)
-		{
-			_registers.A ^= _memory.readByte((_registers.H << 8) + _registers.L);
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-			resetFlag(FLAG_N);
-			resetFlag(FLAG_H);
-			resetFlag(FLAG_C);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xEE: // XOR A, #
-		{
-			_registers.A ^= _memory.readByte(_registers.pc++);
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z); 
-			else
-				resetFlag(FLAG_Z);
-			resetFlag(FLAG_N);
-			resetFlag(FLAG_H);
-			resetFlag(FLAG_C);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x8F: // ADC A, A
-		{
-			byte flagC = getFlag(FLAG_C);
-
-			if (0x0F - (_registers.A & 0x0F) < flagC + (_registers.A & 0x0F))
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			if (0xFF - _registers.A < flagC + _registers.A)
-				setFlag(FLAG_C);
-			else
-				resetFlag(FLAG_C);
-
-			resetFlag(FLAG_N);
-
-			_registers.A += flagC + _registers.A;
-
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x88: // ADC A, B
-		{			
-			byte flagC = getFlag(FLAG_C);
-
-			if (0x0F - (_registers.A & 0x0F) < flagC + (_registers.B & 0x0F))
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			if (0xFF - _registers.A < flagC + _registers.B)
-				setFlag(FLAG_C);
-			else
-				resetFlag(FLAG_C);
-
-			resetFlag(FLAG_N);
-
-			_registers.A += flagC + _registers.B;
-
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x89: // ADC A, C
-		{
-			byte flagC = getFlag(FLAG_C);
-
-			if (0x0F - (_registers.A & 0x0F) < flagC + (_registers.C & 0x0F))
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			if (0xFF - _registers.A < flagC + _registers.C)
-				setFlag(FLAG_C);
-			else
-				resetFlag(FLAG_C);
-
-			resetFlag(FLAG_N);
-
-			_registers.A += flagC + _registers.C;
-
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x8A: // ADC A, D
-		{
-			byte flagC = getFlag(FLAG_C);
-
-			if (0x0F - (_registers.A & 0x0F) < flagC + (_registers.D & 0x0F))
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			if (0xFF - _registers.A < flagC + _registers.D)
-				setFlag(FLAG_C);
-			else
-				resetFlag(FLAG_C);
-
-			resetFlag(FLAG_N);
-
-			_registers.A += flagC + _registers.D;
-
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x8B: // ADC A, E
-		{
-			byte flagC = getFlag(FLAG_C);
-
-			if (0x0F - (_registers.A & 0x0F) < flagC + (_registers.E & 0x0F))
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			if (0xFF - _registers.A < flagC + _registers.E)
-				setFlag(FLAG_C);
-			else
-				resetFlag(FLAG_C);
-
-			resetFlag(FLAG_N);
-
-			_registers.A += flagC + _registers.E;
-
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x8C: // ADC A, H
-		{
-			byte flagC = getFlag(FLAG_C);
-
-			if (0x0F - (_registers.A & 0x0F) < flagC + (_registers.H & 0x0F))
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			if (0xFF - _registers.A < flagC + _registers.H)
-				setFlag(FLAG_C);
-			else
-				resetFlag(FLAG_C);
-
-			resetFlag(FLAG_N);
-
-			_registers.A += flagC + _registers.H;
-
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x8D: // ADC A, L
-		{
-			byte flagC = getFlag(FLAG_C);
-
-			if (0x0F - (_registers.A & 0x0F) < flagC + (_registers.L & 0x0F))
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			if (0xFF - _registers.A < flagC + _registers.L)
-				setFlag(FLAG_C);
-			else
-				resetFlag(FLAG_C);
-
-			resetFlag(FLAG_N);
-
-			_registers.A += flagC + _registers.L;
-
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x8E: // ADC A, (HL)
-		{
-			byte flagC = getFlag(FLAG_C);
-			byte val = _memory.readByte((_registers.H << 8) + _registers.L);
-
-			if (0x0F - (_registers.A & 0x0F) < flagC + (val & 0x0F))
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			if (0xFF - _registers.A < flagC + val)
-				setFlag(FLAG_C);
-			else
-				resetFlag(FLAG_C);
-
-			resetFlag(FLAG_N);
-
-			_registers.A += flagC + val;
-
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xCE: // ADC A, #
-		{
-			byte flagC = getFlag(FLAG_C);
-			byte val = _memory.readByte(_registers.pc++);
-
-			if (0x0F - (_registers.A & 0x0F) < flagC + (val & 0x0F))
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			if (0xFF - _registers.A < flagC + val)
-				setFlag(FLAG_C);
-			else
-				resetFlag(FLAG_C);
-
-			resetFlag(FLAG_N);
-
-			_registers.A += flagC + val;
-
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x9F: // SBC A, A
-		{
-			byte flagC = getFlag(FLAG_C);
-
-			int regALoNibble = _registers.A & 0x0F;
-			int otherLoNibble = flagC + (_registers.A & 0x0F);
-			if (regALoNibble < otherLoNibble)
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			int regA = _registers.A;
-			int other = flagC + _registers.A;
-
-			if (regA < other)
-				setFlag(FLAG_C);
-			else
-				resetFlag(FLAG_C);
-
-			setFlag(FLAG_N);
-
-			_registers.A -= flagC + _registers.A;
-
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x98: // SBC A, B
-		{
-			byte flagC = getFlag(FLAG_C);
-
-			int regALoNibble = _registers.A & 0x0F;
-			int otherLoNibble = flagC + (_registers.B & 0x0F);
-			if (regALoNibble < otherLoNibble)
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			int regA = _registers.A;
-			int other = flagC + _registers.B;
-
-			if (regA < other)
-				setFlag(FLAG_C);
-			else
-				resetFlag(FLAG_C);
-
-			setFlag(FLAG_N);
-
-			_registers.A -= flagC + _registers.B;
-
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x99: // SBC A, C
-		{
-			byte flagC = getFlag(FLAG_C);
-
-			int regALoNibble = _registers.A & 0x0F;
-			int otherLoNibble = flagC + (_registers.C & 0x0F);
-			if (regALoNibble < otherLoNibble)
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			int regA = _registers.A;
-			int other = flagC + _registers.C;
-
-			if (regA < other)
-				setFlag(FLAG_C);
-			else
-				resetFlag(FLAG_C);
-
-			setFlag(FLAG_N);
-
-			_registers.A -= flagC + _registers.C;
-
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x9A: // SBC A, D
-		{
-			byte flagC = getFlag(FLAG_C);
-
-			int regALoNibble = _registers.A & 0x0F;
-			int otherLoNibble = flagC + (_registers.D & 0x0F);
-			if (regALoNibble < otherLoNibble)
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			int regA = _registers.A;
-			int other = flagC + _registers.D;
-
-			if (regA < other)
-				setFlag(FLAG_C);
-			else
-				resetFlag(FLAG_C);
-
-			setFlag(FLAG_N);
-
-			_registers.A -= flagC + _registers.D;
-
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x9B: // SBC A, E
-		{
-			byte flagC = getFlag(FLAG_C);
-
-			int regALoNibble = _registers.A & 0x0F;
-			int otherLoNibble = flagC + (_registers.E & 0x0F);
-			if (regALoNibble < otherLoNibble)
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			int regA = _registers.A;
-			int other = flagC + _registers.E;
-
-			if (regA < other)
-				setFlag(FLAG_C);
-			else
-				resetFlag(FLAG_C);
-
-			setFlag(FLAG_N);
-
-			_registers.A -= flagC + _registers.E;
-
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x9C: // SBC A, H
-		{
-			byte flagC = getFlag(FLAG_C);
-
-			int regALoNibble = _registers.A & 0x0F;
-			int otherLoNibble = flagC + (_registers.H & 0x0F);
-			if (regALoNibble < otherLoNibble)
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			int regA = _registers.A;
-			int other = flagC + _registers.H;
-
-			if (regA < other)
-				setFlag(FLAG_C);
-			else
-				resetFlag(FLAG_C);
-
-			setFlag(FLAG_N);
-
-			_registers.A -= flagC + _registers.H;
-
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x9D: // SBC A, L
-		{
-			byte flagC = getFlag(FLAG_C);
-
-			int regALoNibble = _registers.A & 0x0F;
-			int otherLoNibble = flagC + (_registers.L & 0x0F);
-			if (regALoNibble < otherLoNibble)
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			int regA = _registers.A;
-			int other = flagC + _registers.L;
-
-			if (regA < other)
-				setFlag(FLAG_C);
-			else
-				resetFlag(FLAG_C);
-
-			setFlag(FLAG_N);
-
-			_registers.A -= flagC + _registers.L;
-
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x9E: // SBC A, (HL)
-		{
-			byte flagC = getFlag(FLAG_C);
-			byte val = _memory.readByte((_registers.H << 8) + _registers.L);
-
-			int regALoNibble = _registers.A & 0x0F;
-			int otherLoNibble = flagC + (val & 0x0F);
-			if (regALoNibble < otherLoNibble)
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			int regA = _registers.A;
-			int other = flagC + val;
-
-			if (regA < other)
-				setFlag(FLAG_C);
-			else
-				resetFlag(FLAG_C);
-
-			setFlag(FLAG_N);
-
-			_registers.A -= flagC + val;
-
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xDE: // SBC A, n
-		{
-			byte flagC = getFlag(FLAG_C);
-			byte val = _memory.readByte(_registers.pc++);
-
-			int regALoNibble = _registers.A & 0x0F;
-			int otherLoNibble = flagC + (val & 0x0F);
-			if (regALoNibble < otherLoNibble)
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			int regA = _registers.A;
-			int other = flagC + val;
-
-			if (regA < other)
-				setFlag(FLAG_C);
-			else
-				resetFlag(FLAG_C);
-
-			setFlag(FLAG_N);
-
-			_registers.A -= flagC + val;
-
-			if (_registers.A == 0x00)
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-
-		// 16-bit ALU
-		case 0x03: // INC BC
-		{
-			if (_registers.C == 0xFF)
-				_registers.B++;
-			_registers.C++;
-			
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x13: // INC DE
-		{
-			if (_registers.E == 0xFF)
-				_registers.D++;
-			_registers.E++;
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x23: // INC HL
-		{
-			if (_registers.L == 0xFF)
-				_registers.H++;
-			_registers.L++;
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x33: // INC SP
-		{
-			_registers.sp++;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x0B: // DEC BC
-		{
-			if (_registers.C == 0x00)
-				_registers.B--;
-			_registers.C--;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x1B: // DEC DE
-		{
-			if (_registers.E == 0x00)
-				_registers.D--;
-			_registers.E--;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x2B: // DEC HL
-		{
-			if (_registers.L == 0x00)
-				_registers.H--;
-			_registers.L--;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x3B: // DEC SP 
-		{
-			_registers.sp--;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x09: // ADD HL, BC
-		{
-			int BC = (_registers.B << 8) + _registers.C;
-			int HL = (_registers.H << 8) + _registers.L;
-			int res = HL + BC;
-
-			if (res & 0xFFFF0000)
-				setFlag(FLAG_C);
-			else
-				resetFlag(FLAG_C);
-
-			if (0xFFF - (HL & 0xFFF) < (BC & 0xFFF))
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			HL += BC;
-
-			_registers.H = (HL >> 8) & 0xFF;
-			_registers.L = HL & 0xFF;
-
-			resetFlag(FLAG_N);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-
-		} break;
-		case 0x19: // ADD HL, DE
-		{
-			int DE = (_registers.D << 8) + _registers.E;
-			int HL = (_registers.H << 8) + _registers.L;
-			int res = HL + DE;
-
-			if (res & 0xFFFF0000)
-				setFlag(FLAG_C);
-			else
-				resetFlag(FLAG_C);
-
-			if (0xFFF - (HL & 0xFFF) < (DE & 0xFFF))
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			HL += DE;
-
-			_registers.H = (HL >> 8) & 0xFF;
-			_registers.L = HL & 0xFF;
-
-			resetFlag(FLAG_N);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x29: // ADD HL, HL
-		{
-			int HL2 = (_registers.H << 8) + _registers.L;
-			int HL = (_registers.H << 8) + _registers.L;
-			int res = HL + HL2;
-
-			if (res & 0xFFFF0000)
-				setFlag(FLAG_C);
-			else
-				resetFlag(FLAG_C);
-
-			if (0xFFF - (HL & 0xFFF) < (HL2 & 0xFFF))
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			HL += HL2;
-
-			_registers.H = (HL >> 8) & 0xFF;
-			_registers.L = HL & 0xFF;
-
-			resetFlag(FLAG_N);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x39: // ADD HL, SP
-		{
-			int SP = _registers.sp;
-			int HL = (_registers.H << 8) + _registers.L;
-			int res = HL + SP;
-
-			if (res & 0xFFFF0000)
-				setFlag(FLAG_C);
-			else
-				resetFlag(FLAG_C);
-
-			if (0xFFF - (HL & 0xFFF) < (SP & 0xFFF))
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			HL += SP;
-
-			_registers.H = (HL >> 8) & 0xFF;
-			_registers.L = HL & 0xFF;
-
-			resetFlag(FLAG_N);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xE8: // ADD SP, n
-		{
-			signed char val = _memory.readByte(_registers.pc++);
-			int result = _registers.sp + val;
-
-			// Gearboy saves the day again
-			if (((_registers.sp ^ val ^ result) & 0x100) == 0x100)
-				setFlag(FLAG_C);
-			else
-				resetFlag(FLAG_C);
-
-			if (((_registers.sp ^ val ^ result) & 0x10) == 0x10)
-				setFlag(FLAG_H);
-			else
-				resetFlag(FLAG_H);
-
-			_registers.sp += val;
-
-			resetFlag(FLAG_Z);
-			resetFlag(FLAG_N);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-
-		// Rotates & Shifts
-		case 0x0F: // RRCA
-		{
-			if ((_registers.A & 0x01) != 0)
-			{
-				_registers.A >>= 1;
-				_registers.A |= 0x80;
-				setFlag(FLAG_C);
-			}
-			else
-			{
-				_registers.A >>= 1;
-				resetFlag(FLAG_C);
-			}
-			
-			resetFlag(FLAG_Z);
-			resetFlag(FLAG_H);
-			resetFlag(FLAG_N);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x17: // RLA
-		{
-			int carry = isFlagSet(FLAG_C) ? 1 : 0;
-
-			if (_registers.A & 0x80)
-				setFlag(FLAG_C);
-			else
-				resetFlag(FLAG_C);
-
-			_registers.A <<= 1;
-			_registers.A += carry;
-
-			resetFlag(FLAG_N);
-			resetFlag(FLAG_Z);
-			resetFlag(FLAG_H);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x1F: // RRA
-		{
-			int carry = (isFlagSet(FLAG_C) ? 1 : 0) << 7;
-
-			if (_registers.A & 0x01) 
-				setFlag(FLAG_C);
-			else
-				resetFlag(FLAG_C);
-
-			_registers.A >>= 1;
-			_registers.A += carry;
-
-			resetFlag(FLAG_N);
-			resetFlag(FLAG_Z);
-			resetFlag(FLAG_H);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x07: // RLCA
-		{		
-			byte carry = (_registers.A & 0x80) >> 7;
-			if (carry) 
-				setFlag(FLAG_C);
-			else
-				resetFlag(FLAG_C);
-
-			_registers.A <<= 1;
-			_registers.A += carry;
-
-			resetFlag(FLAG_N);
-			resetFlag(FLAG_Z);
-			resetFlag(FLAG_H);
-			
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-
-		// Calls
-		case 0xCD: // Call nn
-		{
-			_registers.sp -= 2;
-			_memory.writeWord(_registers.sp, _registers.pc + 2);
-			_registers.pc = _memory.readWord(_registers.pc);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2; //TODO: check correct timing manual says 12Cycles
-		} break;
-		case 0xC4: // CALL NZ, nn
-		{
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-			if (!isFlagSet(FLAG_Z)) 
-			{
-				_registers.sp -= 2;
-				_memory.writeWord(_registers.sp, _registers.pc + 2);
-				_registers.pc = _memory.readWord(_registers.pc);
-				_registers.M += 2;
-				_registers.T += 8; 
-			}
-			else 
-				_registers.pc += 2;
-
-		} break;
-		case 0xCC: // CALL Z, nn
-		{
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-			if (isFlagSet(FLAG_Z))
-			{
-				_registers.sp -= 2;
-				_memory.writeWord(_registers.sp, _registers.pc + 2);
-				_registers.pc = _memory.readWord(_registers.pc);
-				_registers.M += 2;
-				_registers.T += 8;
-			}
-			else
-				_registers.pc += 2;
-		} break;
-		case 0xD4: // CALL NC, nn
-		{
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-			if (!isFlagSet(FLAG_C))
-			{
-				_registers.sp -= 2;
-				_memory.writeWord(_registers.sp, _registers.pc + 2);
-				_registers.pc = _memory.readWord(_registers.pc);
-				_registers.M += 2;
-				_registers.T += 8;
-			}
-			else
-				_registers.pc += 2;
-		} break;
-		case 0xDC: // CALL C, nn
-		{
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-			if (isFlagSet(FLAG_C))
-			{
-				_registers.sp -= 2;
-				_memory.writeWord(_registers.sp, _registers.pc + 2);
-				_registers.pc = _memory.readWord(_registers.pc);
-				_registers.M += 2;
-				_registers.T += 8;
-			}
-			else
-				_registers.pc += 2;
-		} break;
-
-		// Jumps
-		case 0x10: // DJNZn
-		{
-			signed char i = _memory.readByte(_registers.pc++);
-			_registers.B--;
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-			if (_registers.B != 0)
-			{
-				_registers.pc += i;
-				_registers.M ++;
-			}
-			
-		} break;
-		case 0xC3: // JP nn
-		{
-			_registers.pc = _memory.readWord(_registers.pc);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xE9: // JP (HL)
-		{
-			_registers.pc = (_registers.H << 8) + _registers.L;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xC2: // JP NZ, nn
-		{
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-			if (!isFlagSet(FLAG_Z))
-			{
-				_registers.pc = _memory.readWord(_registers.pc);
-				_registers.M++;
-				_registers.T += 4;
-			}
-			else
-			{
-				_registers.pc += 2;
-			}
-		} break;
-		case 0xCA: // JP Z, nn
-		{
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-			if (isFlagSet(FLAG_Z))
-			{
-				_registers.pc = _memory.readWord(_registers.pc);
-				_registers.M++;
-				_registers.T += 4;
-			}
-			else
-			{
-				_registers.pc += 2;
-			}
-		} break;
-		case 0xD2: // JP NC, nn
-		{
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-			if (!isFlagSet(FLAG_C))
-			{
-				_registers.pc = _memory.readWord(_registers.pc);
-				_registers.M++;
-				_registers.T += 4;
-			}
-			else
-			{
-				_registers.pc += 2;
-			}
-		} break;
-		case 0xDA: // JP C, nn
-		{
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-			if (isFlagSet(FLAG_C))
-			{
-				_registers.pc = _memory.readWord(_registers.pc);
-				_registers.M++;
-				_registers.T += 4;
-			}
-			else
-			{
-				_registers.pc += 2;
-			}
-		} break;
-
-		case 0x18: // JR n
-		{
-			signed char n = _memory.readByte(_registers.pc);
-			_registers.pc++;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-			_registers.pc += n;
-			_registers.M++;
-			_registers.T += 4;
-		} break;
-		case 0x20: // JR NZ,n
-		{
-			signed char nextByte = _memory.readByte(_registers.pc);
-			_registers.pc++;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-			if (!isFlagSet(FLAG_Z))
-			{
-				_registers.pc += nextByte;
-				_registers.M++; 
-				_registers.T += 4;
-			}
-		} break;
-		case 0x28: // JR Z,n
-		{
-			signed char nextByte = _memory.readByte(_registers.pc);
-			_registers.pc++;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-			if (isFlagSet(FLAG_Z))
-			{
-				_registers.pc += nextByte;
-				_registers.M++;
-				_registers.T += 4;
-			}
-		} break;
-		case 0x30: // JR NC,n
-		{
-			signed char nextByte = _memory.readByte(_registers.pc);
-			_registers.pc++;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-			if (!isFlagSet(FLAG_C))
-			{
-				_registers.pc += nextByte;
-				_registers.M++;
-				_registers.T += 4;
-			}
-		} break;
-		case 0x38: // JR C,n
-		{
-			signed char nextByte = _memory.readByte(_registers.pc);
-			_registers.pc++;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-			if (isFlagSet(FLAG_C))
-			{
-				_registers.pc += nextByte;
-				_registers.M++;
-				_registers.T += 4;
-			}
-		} break;
-
-		// Returns
-		case 0xC9: // RET
-		{
-			_registers.pc = _memory.readWord(_registers.sp);
-			_registers.sp += 2;
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xC0: // RET NZ
-		{
-			if (!isFlagSet(FLAG_Z))
-			{
-				_registers.pc = _memory.readWord(_registers.sp);
-				_registers.sp += 2;
-			}
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xC8: // RET Z
-		{
-			if (isFlagSet(FLAG_Z))
-			{
-				_registers.pc = _memory.readWord(_registers.sp);
-				_registers.sp += 2;
-			}
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xD0: // RET NC
-		{
-			if (!isFlagSet(FLAG_C))
-			{
-				_registers.pc = _memory.readWord(_registers.sp);
-				_registers.sp += 2;
-			}
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xD8: // RET C
-		{
-			if (isFlagSet(FLAG_C))
-			{
-				_registers.pc = _memory.readWord(_registers.sp);
-				_registers.sp += 2;
-			}
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xD9: // RETI
-		{
-			_registers.ime = 1;
-
-			_registers.pc = _memory.readWord(_registers.sp);
-			_registers.sp += 2;
+		_registers.F = (_registers.F & FLAG_C) | zeroFlag(val) | FLAG_N | (static_cast<byte>((val & 0x0F) == 0x0F) << 5);
+	}
+	else if ((opcode & 0xC7) == 0x06) // LD r, n
+	{
+		writeOperand<dst>(immediateByte());
+	}
+	else
+	{
+		std::cout << ">>> at: 0x" << std::hex << _registers.pc << " unimplemented instruction: 0x" << std::hex << static_cast<int>(_opcode) << " <<<" << std::endl;
+		_errorState = ES_UNIMPLEMENTED_INSTRUCTION;
+	}
+}
 
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
+// All CB prefixed opcodes are register variants of shifts, BIT, RES and SET
+template<byte opcode>
+void Cpu::executeCbOpcode()
+{
+	const byte bit     = (opcode >> 3) & 7;
+	const byte operand = opcode & 7;
 
-		// Misc
-		case 0x76: // HALT
+	switch (opcode >> 6)
+	{
+		case 0: // RLC, RRC, RL, RR, SLA, SRA, SWAP, SRL
 		{
-			if ((_memory.getIE() & _memory.getIF()) != 0)
-				_halted = true;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
+			writeOperand<operand>(executeShiftOperation<bit>(readOperand<operand>()));
 		} break;
 
-		case 0x27: // DAA
-		{		
-			word s = _registers.A;
-
-			if (isFlagSet(FLAG_N)) 
-			{
-				if (isFlagSet(FLAG_H)) s = (s - 0x06) & 0xFF;
-				if (isFlagSet(FLAG_C)) s -= 0x60;
-			}
-			else 
-			{
-				if (isFlagSet(FLAG_H) || (s & 0xF) > 9) s += 0x06;
-				if (isFlagSet(FLAG_C) || s > 0x9F) s += 0x60;
-			}
-
-			_registers.A = (s & 0xFF);
-			resetFlag(FLAG_H);
-			
-			if (_registers.A == 0x00) 
-				setFlag(FLAG_Z);
-			else
-				resetFlag(FLAG_Z);
-			
-			if (s >= 0x100) 
-				setFlag(FLAG_C);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xF3: // DI
-		{
-			_registers.ime = 0;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xFB: // EI
-		{
-			_registers.ime = 1;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		// Restarts
-		case 0xC7: // RST 0x00
+		case 1: // BIT b, r
 		{
-			_registers.sp -= 2;
-			_memory.writeWord(_registers.sp, _registers.pc);
-			_registers.pc = 0x00;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
+			_registers.F = (_registers.F & FLAG_C) | zeroFlag(readOperand<operand>() & (1 << bit)) | FLAG_H;
 		} break;
-		case 0xCF: // RST 0x08
-		{
-			_registers.sp -= 2;
-			_memory.writeWord(_registers.sp, _registers.pc);
-			_registers.pc = 0x08;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xD7: // RST 0x10
-		{
-			_registers.sp -= 2;
-			_memory.writeWord(_registers.sp, _registers.pc);
-			_registers.pc = 0x10;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xDF: // RST 0x18
-		{
-			_registers.sp -= 2;
-			_memory.writeWord(_registers.sp, _registers.pc);
-			_registers.pc = 0x18;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xE7: // RST 0x20
-		{
-			_registers.sp -= 2;
-			_memory.writeWord(_registers.sp, _registers.pc);
-			_registers.pc = 0x20;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xEF: // RST 0x28
-		{
-			_registers.sp -= 2;
-			_memory.writeWord(_registers.sp, _registers.pc);
-			_registers.pc = 0x28;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xF7: // RST 0x30
-		{
-			_registers.sp -= 2;
-			_memory.writeWord(_registers.sp, _registers.pc);
-			_registers.pc = 0x30;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0xFF: // RST 0x38
-		{
-			_registers.sp -= 2;
-			_memory.writeWord(_registers.sp, _registers.pc);
-			_registers.pc = 0x38;
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;						
-		case 0x2F: // CPL
-		{
-			_registers.A = ~_registers.A;
-			setFlag(FLAG_N);
-			setFlag(FLAG_H);
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x37: // SCF
-		{			
-			setFlag(FLAG_C);
-			resetFlag(FLAG_N);
-			resetFlag(FLAG_H);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-		case 0x3F: // CCF
-		{
-			if (isFlagSet(FLAG_C))
-				resetFlag(FLAG_C);
-			else
-				setFlag(FLAG_C);
-
-			resetFlag(FLAG_N);
-			resetFlag(FLAG_H);
-
-			_registers.M = coreInstructionTicks[_opcode] / 2;
-			_registers.T = coreInstructionTicks[_opcode] * 2;
-		} break;
-
-		// CB
-		case 0xCB:
-		{
-			_opcode      = _memory.readByte(_registers.pc++);
-			_isBitOpcode = true;
-			switch (_opcode)
-			{
-				case 0x47: // BIT 0A
-				{
-					if ((_registers.A & 0x01) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x4F: // BIT 1A
-				{
-					if ((_registers.A & 0x02) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x57: // BIT 2A
-				{
-					if ((_registers.A & 0x04) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x5F: // BIT 3A
-				{
-					if ((_registers.A & 0x08) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x67: // BIT 4A
-				{
-					if ((_registers.A & 0x10) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x6F: // BIT 5A
-				{
-					if ((_registers.A & 0x20) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x77: // BIT 6A
-				{
-					if ((_registers.A & 0x40) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x7F: // BIT 7A
-				{
-					if ((_registers.A & 0x80) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x40: // BIT 0B
-				{
-					if ((_registers.B & 0x01) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x48: // BIT 1B
-				{
-					if ((_registers.B & 0x02) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x50: // BIT 2B
-				{
-					if ((_registers.B & 0x04) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x58: // BIT 3B
-				{
-					if ((_registers.B & 0x08) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x60: // BIT 4B
-				{
-					if ((_registers.B & 0x10) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x68: // BIT 5B
-				{
-					if ((_registers.B & 0x20) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x70: // BIT 6B
-				{
-					if ((_registers.B & 0x40) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x78: // BIT 7B
-				{
-					if ((_registers.B & 0x80) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x41: // BIT 0C
-				{
-					if ((_registers.C & 0x01) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x49: // BIT 1C
-				{
-					if ((_registers.C & 0x02) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x51: // BIT 2C
-				{
-					if ((_registers.C & 0x04) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x59: // BIT 3C
-				{
-					if ((_registers.C & 0x08) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x61: // BIT 4C
-				{
-					if ((_registers.C & 0x10) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x69: // BIT 5C
-				{
-					if ((_registers.C & 0x20) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x71: // BIT 6C
-				{
-					if ((_registers.C & 0x40) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x79: // BIT 7C
-				{
-					if ((_registers.C & 0x80) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x42: // BIT 0D
-				{
-					if ((_registers.D & 0x01) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x4A: // BIT 1D
-				{
-					if ((_registers.D & 0x02) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x52: // BIT 2D
-				{
-					if ((_registers.D & 0x04) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x5A: // BIT 3D
-				{
-					if ((_registers.D & 0x08) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x62: // BIT 4D
-				{
-					if ((_registers.D & 0x10) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x6A: // BIT 5D
-				{
-					if ((_registers.D & 0x20) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x72: // BIT 6D
-				{
-					if ((_registers.D & 0x40) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x7A: // BIT 7D
-				{
-					if ((_registers.D & 0x80) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x43: // BIT 0E
-				{
-					if ((_registers.E & 0x01) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x4B: // BIT 1E
-				{
-					if ((_registers.E & 0x02) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x53: // BIT 2E
-				{
-					if ((_registers.E & 0x04) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x5B: // BIT 3E
-				{
-					if ((_registers.E & 0x08) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x63: // BIT 4E
-				{
-					if ((_registers.E & 0x10) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x6B: // BIT 5E
-				{
-					if ((_registers.E & 0x20) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x73: // BIT 6E
-				{
-					if ((_registers.E & 0x40) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x7B: // BIT 7E
-				{
-					if ((_registers.E & 0x80) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x44: // BIT 0H
-				{
-					if ((_registers.H & 0x01) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x4C: // BIT 1H
-				{
-					if ((_registers.H & 0x02) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x54: // BIT 2H
-				{
-					if ((_registers.H & 0x04) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x5C: // BIT 3H
-				{
-					if ((_registers.H & 0x08) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x64: // BIT 4H
-				{
-					if ((_registers.H & 0x10) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x6C: // BIT 5H
-				{
-					if ((_registers.H & 0x20) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x74: // BIT 6H
-				{
-					if ((_registers.H & 0x40) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x7C: // BIT 7H
-				{
-					if ((_registers.H & 0x80) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x45: // BIT 0L
-				{
-					if ((_registers.L & 0x01) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x4D: // BIT 1L
-				{
-					if ((_registers.L & 0x02) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x55: // BIT 2L
-				{
-					if ((_registers.L & 0x04) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x5D: // BIT 3L
-				{
-					if ((_registers.L & 0x08) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x65: // BIT 4L
-				{
-					if ((_registers.L & 0x10) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x6D: // BIT 5L
-				{
-					if ((_registers.L & 0x20) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x75: // BIT 6L
-				{
-					if ((_registers.L & 0x40) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x7D: // BIT 7L
-				{
-					if ((_registers.L & 0x80) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x46: // BIT 0HL
-				{
-					byte val = _memory.readByte((_registers.H << 8) + _registers.L);
-					if ((val & 0x01) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x4E: // BIT 1HL
-				{
-					byte val = _memory.readByte((_registers.H << 8) + _registers.L);
-					if ((val & 0x02) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x56: // BIT 2HL
-				{
-					byte val = _memory.readByte((_registers.H << 8) + _registers.L);
-					if ((val & 0x04) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x5E: // BIT 3HL
-				{
-					byte val = _memory.readByte((_registers.H << 8) + _registers.L);
-					if ((val & 0x08) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x66: // BIT 4HL
-				{
-					byte val = _memory.readByte((_registers.H << 8) + _registers.L);
-					if ((val & 0x10) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x6E: // BIT 5HL
-				{
-					byte val = _memory.readByte((_registers.H << 8) + _registers.L);
-					if ((val & 0x20) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x76: // BIT 6HL
-				{
-					byte val = _memory.readByte((_registers.H << 8) + _registers.L);
-					if ((val & 0x40) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x7E: // BIT 7HL
-				{
-					byte val = _memory.readByte((_registers.H << 8) + _registers.L);
-					if ((val & 0x80) != 0)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					resetFlag(FLAG_N);
-					setFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x87: // RES 0, A
-				{
-					_registers.A &= ~0x01;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x8F: // RES 1, A
-				{
-					_registers.A &= ~0x02;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x97: // RES 2, A
-				{
-					_registers.A &= ~0x04;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x9F: // RES 3, A
-				{
-					_registers.A &= ~0x08;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xA7: // RES 4, A
-				{
-					_registers.A &= ~0x10;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xAF: // RES 5, A
-				{
-					_registers.A &= ~0x20;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xB7: // RES 6, A
-				{
-					_registers.A &= ~0x40;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xBF: // RES 7, A
-				{
-					_registers.A &= ~0x80;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x80: // RES 0, B
-				{
-					_registers.B &= ~0x1;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x88: // RES 1, B
-				{
-					_registers.B &= ~0x02;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x90: // RES 2, B
-				{
-					_registers.B &= ~0x04;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x98: // RES 3, B
-				{
-					_registers.B &= ~0x08;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xA0: // RES 4, B
-				{
-					_registers.B &= ~0x10;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xA8: // RES 5, B
-				{
-					_registers.B &= ~0x20;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xB0: // RES 6, B
-				{
-					_registers.B &= ~0x40;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xB8: // RES 7, B
-				{
-					_registers.B &= ~0x80;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x81: // RES 0, C
-				{
-					_registers.C &= ~0x1;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x89: // RES 1, C
-				{
-					_registers.C &= ~0x02;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x91: // RES 2, C
-				{
-					_registers.C &= ~0x04;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x99: // RES 3, C
-				{
-					_registers.C &= ~0x08;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xA1: // RES 4, C
-				{
-					_registers.C &= ~0x10;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xA9: // RES 5, C
-				{
-					_registers.C &= ~0x20;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xB1: // RES 6, C
-				{
-					_registers.C &= ~0x40;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xB9: // RES 7, C
-				{
-					_registers.C &= ~0x80;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x82: // RES 0, D
-				{
-					_registers.D &= ~0x1;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x8A: // RES 1, D
-				{
-					_registers.D &= ~0x02;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x92: // RES 2, D
-				{
-					_registers.D &= ~0x04;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x9A: // RES 3, D
-				{
-					_registers.D &= ~0x08;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xA2: // RES 4, D
-				{
-					_registers.D &= ~0x10;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xAA: // RES 5, D
-				{
-					_registers.D &= ~0x20;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xB2: // RES 6, D
-				{
-					_registers.D &= ~0x40;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xBA: // RES 7, D
-				{
-					_registers.D &= ~0x80;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x83: // RES 0, E
-				{
-					_registers.E &= ~0x1;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x8B: // RES 1, E
-				{
-					_registers.E &= ~0x02;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x93: // RES 2, E
-				{
-					_registers.E &= ~0x04;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x9B: // RES 3, E
-				{
-					_registers.E &= ~0x08;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xA3: // RES 4, E
-				{
-					_registers.E &= ~0x10;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xAB: // RES 5, E
-				{
-					_registers.E &= ~0x20;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xB3: // RES 6, E
-				{
-					_registers.E &= ~0x40;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xBB: // RES 7, E
-				{
-					_registers.E &= ~0x80;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x84: // RES 0, H
-				{
-					_registers.H &= ~0x01;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x8C: // RES 1, H
-				{
-					_registers.H &= ~0x02;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x94: // RES 2, H
-				{
-					_registers.H &= ~0x04;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x9C: // RES 3, H
-				{
-					_registers.H &= ~0x08;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xA4: // RES 4, H
-				{
-					_registers.H &= ~0x10;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xAC: // RES 5, H
-				{
-					_registers.H &= ~0x20;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xB4: // RES 6, H
-				{
-					_registers.H &= ~0x40;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xBC: // RES 7, H
-				{
-					_registers.H &= ~0x80;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x85: // RES 0, L
-				{
-					_registers.L &= ~0x1;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x8D: // RES 1, L
-				{
-					_registers.L &= ~0x02;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x95: // RES 2, L
-				{
-					_registers.L &= ~0x04;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x9D: // RES 3, L
-				{
-					_registers.L &= ~0x08;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xA5: // RES 4, L
-				{
-					_registers.L &= ~0x10;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xAD: // RES 5, L
-				{
-					_registers.L &= ~0x20;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xB5: // RES 6, L
-				{
-					_registers.L &= ~0x40;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xBD: // RES 7, L
-				{
-					_registers.L &= ~0x80;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;				
-				case 0x86: // RES 0, (HL)
-				{
-					byte val = _memory.readByte((_registers.H << 8) + _registers.L);
-					val &= ~0x1;
-					_memory.writeByte((_registers.H << 8) + _registers.L, val);					
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x8E: // RES 1, (HL)
-				{
-					byte val = _memory.readByte((_registers.H << 8) + _registers.L);
-					val &= ~0x2;
-					_memory.writeByte((_registers.H << 8) + _registers.L, val);
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x96: // RES 2, (HL)
-				{
-					byte val = _memory.readByte((_registers.H << 8) + _registers.L);
-					val &= ~0x4;
-					_memory.writeByte((_registers.H << 8) + _registers.L, val);
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x9E: // RES 3, (HL)
-				{
-					byte val = _memory.readByte((_registers.H << 8) + _registers.L);
-					val &= ~0x8;
-					_memory.writeByte((_registers.H << 8) + _registers.L, val);
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xA6: // RES 4, (HL)
-				{
-					byte val = _memory.readByte((_registers.H << 8) + _registers.L);
-					val &= ~0x10;
-					_memory.writeByte((_registers.H << 8) + _registers.L, val);
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xAE: // RES 5, (HL)
-				{
-					byte val = _memory.readByte((_registers.H << 8) + _registers.L);
-					val &= ~0x20;
-					_memory.writeByte((_registers.H << 8) + _registers.L, val);
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xB6: // RES 6, (HL)
-				{
-					byte val = _memory.readByte((_registers.H << 8) + _registers.L);
-					val &= ~0x40;
-					_memory.writeByte((_registers.H << 8) + _registers.L, val);
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xBE: // RES 7, (HL)
-				{
-					byte val = _memory.readByte((_registers.H << 8) + _registers.L);
-					val &= ~0x80;
-					_memory.writeByte((_registers.H << 8) + _registers.L, val);
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x17: // RL A
-				{
-					byte prevCarry = getFlag(FLAG_C);
-					byte prevSeventhBit = (_registers.A & 0x80) != 0 ? 0x01 : 0x00;
-
-					_registers.A <<= 1;
-
-					resetFlag(FLAG_N);
-					resetFlag(FLAG_H);
-					if (prevSeventhBit)
-						setFlag(FLAG_C);
-					else
-						resetFlag(FLAG_C);
-
-					if (prevCarry)
-						_registers.A |= 0x01;
-					else
-						_registers.A &= ~0x01;
-
-					if (_registers.A == 0)
-						setFlag(FLAG_Z);
-					else
-						resetFlag(FLAG_Z);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x10: // RL B
-				{
-					byte prevCarry = getFlag(FLAG_C);
-					byte prevSeventhBit = (_registers.B & 0x80) != 0 ? 0x01 : 0x00;
-
-					_registers.B <<= 1;
-
-					resetFlag(FLAG_N);
-					resetFlag(FLAG_H);
-					if (prevSeventhBit)
-						setFlag(FLAG_C);
-					else
-						resetFlag(FLAG_C);
-
-					if (prevCarry)
-						_registers.B |= 0x01;
-					else
-						_registers.B &= ~0x01;
-
-					if (_registers.B == 0)
-						setFlag(FLAG_Z);
-					else
-						resetFlag(FLAG_Z);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x11: // RL C
-				{
-					byte prevCarry = getFlag(FLAG_C);
-					byte prevSeventhBit = (_registers.C & 0x80) != 0 ? 0x01 : 0x00;
-
-					_registers.C <<= 1;
-					
-					resetFlag(FLAG_N);
-					resetFlag(FLAG_H);
-					if (prevSeventhBit)
-						setFlag(FLAG_C);
-					else
-						resetFlag(FLAG_C);
-					
-					if (prevCarry)
-						_registers.C |= 0x01;
-					else
-						_registers.C &= ~0x01;
-
-					if (_registers.C == 0)
-						setFlag(FLAG_Z);
-					else
-						resetFlag(FLAG_Z);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x12: // RL D
-				{
-					byte prevCarry = getFlag(FLAG_C);
-					byte prevSeventhBit = (_registers.D & 0x80) != 0 ? 0x01 : 0x00;
-
-					_registers.D <<= 1;
-
-					resetFlag(FLAG_N);
-					resetFlag(FLAG_H);
-					if (prevSeventhBit)
-						setFlag(FLAG_C);
-					else
-						resetFlag(FLAG_C);
-
-					if (prevCarry)
-						_registers.D |= 0x01;
-					else
-						_registers.D &= ~0x01;
-
-					if (_registers.D == 0)
-						setFlag(FLAG_Z);
-					else
-						resetFlag(FLAG_Z);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x13: // RL E
-				{
-					byte prevCarry = getFlag(FLAG_C);
-					byte prevSeventhBit = (_registers.E & 0x80) != 0 ? 0x01 : 0x00;
-
-					_registers.E <<= 1;
-
-					resetFlag(FLAG_N);
-					resetFlag(FLAG_H);
-					if (prevSeventhBit)
-						setFlag(FLAG_C);
-					else
-						resetFlag(FLAG_C);
-
-					if (prevCarry)
-						_registers.E |= 0x01;
-					else
-						_registers.E &= ~0x01;
-
-					if (_registers.E == 0)
-						setFlag(FLAG_Z);
-					else
-						resetFlag(FLAG_Z);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x14: // RL H
-				{
-					byte prevCarry = getFlag(FLAG_C);
-					byte prevSeventhBit = (_registers.H & 0x80) != 0 ? 0x01 : 0x00;
-
-					_registers.H <<= 1;
-
-					resetFlag(FLAG_N);
-					resetFlag(FLAG_H);
-					if (prevSeventhBit)
-						setFlag(FLAG_C);
-					else
-						resetFlag(FLAG_C);
-
-					if (prevCarry)
-						_registers.H |= 0x01;
-					else
-						_registers.H &= ~0x01;
-
-					if (_registers.H == 0)
-						setFlag(FLAG_Z);
-					else
-						resetFlag(FLAG_Z);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x15: // RL L
-				{
-					byte prevCarry = getFlag(FLAG_C);
-					byte prevSeventhBit = (_registers.L & 0x80) != 0 ? 0x01 : 0x00;
-
-					_registers.L <<= 1;
-
-					resetFlag(FLAG_N);
-					resetFlag(FLAG_H);
-					if (prevSeventhBit)
-						setFlag(FLAG_C);
-					else
-						resetFlag(FLAG_C);
-
-					if (prevCarry)
-						_registers.L |= 0x01;
-					else
-						_registers.L &= ~0x01;
-
-					if (_registers.L == 0)
-						setFlag(FLAG_Z);
-					else
-						resetFlag(FLAG_Z);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x16: // RL (HL)
-				{
-					byte prevCarry = getFlag(FLAG_C);
-					byte val = _memory.readByte((_registers.H << 8) + _registers.L);
-					byte prevSeventhBit = (val & 0x80) != 0 ? 0x01 : 0x00;
-
-					val <<= 1;
-
-					resetFlag(FLAG_N);
-					resetFlag(FLAG_H);
-					if (prevSeventhBit)
-						setFlag(FLAG_C);
-					else
-						resetFlag(FLAG_C);
-
-					if (prevCarry)
-						val |= 0x01;
-					else
-						val &= ~0x01;
-
-					if (val == 0)
-						setFlag(FLAG_Z);
-					else
-						resetFlag(FLAG_Z);
-
-					_memory.writeByte((_registers.H << 8) + _registers.L, val);
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x1F: // RR A
-				{
-					byte lsb = _registers.A & 0x01;
-					byte prevCarry = getFlag(FLAG_C);
 
-					if (lsb)
-						setFlag(FLAG_C);
-					else
-						resetFlag(FLAG_C);
+		case 2: // RES b, r
+		{
+			writeOperand<operand>(readOperand<operand>() & ~(1 << bit));
+		} break;
 
-					_registers.A >>= 1;
+		case 3: // SET b, r
+		{
+			writeOperand<operand>(readOperand<operand>() | (1 << bit));
+		} break;
+	}
+}
 
-					if (prevCarry)
-						_registers.A |= 0x80;
-					else
-						_registers.A &= ~0x80;
+template<> void Cpu::executeCoreOpcode<0x00>() // NOP
+{
+}
 
-					resetFlag(FLAG_N);
-					resetFlag(FLAG_H);
+// 8 Bit Loads
 
-					if (_registers.A == 0x00)
-						setFlag(FLAG_Z);
-					else
-						resetFlag(FLAG_Z);
+template<> void Cpu::executeCoreOpcode<0xF2>() // LD A, (C)
+{
+	_registers.A = _memory.readByte(0xFF00 + _registers.C);
+}
 
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x18: // RR B
-				{
-					byte lsb = _registers.B & 0x01;
-					byte prevCarry = getFlag(FLAG_C);
+template<> void Cpu::executeCoreOpcode<0x0A>() // LD A, (BC)
+{
+	_registers.A = _memory.readByte((_registers.B << 8) + _registers.C);
+}
 
-					if (lsb)
-						setFlag(FLAG_C);
-					else
-						resetFlag(FLAG_C);
+template<> void Cpu::executeCoreOpcode<0x1A>() // LD A, (DE)
+{
+	_registers.A = _memory.readByte((_registers.D << 8) + _registers.E);
+}
 
-					_registers.B >>= 1;
+template<> void Cpu::executeCoreOpcode<0xFA>() // LD A, (nn)
+{
+	word address = _immediate;
+	_registers.pc += 2;
+	_registers.A = _memory.readByte(address);
+}
 
-					if (prevCarry)
-						_registers.B |= 0x80;
-					else
-						_registers.B &= ~0x80;
+template<> void Cpu::executeCoreOpcode<0xF8>() // LDHL SP, n
+{
+	signed char val = immediateByte();
+	int result = _registers.sp + val;
 
-					resetFlag(FLAG_N);
-					resetFlag(FLAG_H);
+	// Gearboy saves the day again
+	if (((_registers.sp ^ val ^ result) & 0x100) == 0x100)
+		setFlag(FLAG_C);
+	else
+		resetFlag(FLAG_C);
 
-					if (_registers.B == 0x00)
-						setFlag(FLAG_Z);
-					else
-						resetFlag(FLAG_Z);
+	if (((_registers.sp ^ val ^ result) & 0x10) == 0x10)
+		setFlag(FLAG_H);
+	else
+		resetFlag(FLAG_H);
 
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x19: // RR C
-				{
-					byte lsb = _registers.C & 0x01;
-					byte prevCarry = getFlag(FLAG_C);
+	resetFlag(FLAG_Z);
+	resetFlag(FLAG_N);
 
-					if (lsb)
-						setFlag(FLAG_C);
-					else
-						resetFlag(FLAG_C);
+	_registers.H = ((result & 0xFF00) >> 8);
+	_registers.L = result & 0x00FF;
+}
 
-					_registers.C >>= 1;
+template<> void Cpu::executeCoreOpcode<0xE0>() // LDH (n), A
+{
+	byte address = immediateByte();
+	_memory.writeByte(0xFF00 + address, _registers.A);
+}
 
-					if (prevCarry)
-						_registers.C |= 0x80;
-					else
-						_registers.C &= ~0x80;
+template<> void Cpu::executeCoreOpcode<0xE2>() // LD (C), A
+{
+	_memory.writeByte(0xFF00 + _registers.C, _registers.A);
+}
 
-					resetFlag(FLAG_N);
-					resetFlag(FLAG_H);
+template<> void Cpu::executeCoreOpcode<0xF0>() // LDH A,(n)
+{
+	word address = immediateByte() + 0xFF00;
+	_registers.A = _memory.readByte(address);
+}
 
-					if (_registers.C == 0x00)
-						setFlag(FLAG_Z);
-					else
-						resetFlag(FLAG_Z);
+template<> void Cpu::executeCoreOpcode<0x22>() // LDI (HL), A
+{
+	_memory.writeByte((_registers.H << 8) + _registers.L, _registers.A);
+	if (_registers.L == 0xFF)
+		_registers.H++;
+	_registers.L++;
+}
 
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x1A: // RR D
-				{
-					byte lsb = _registers.D & 0x01;
-					byte prevCarry = getFlag(FLAG_C);
+template<> void Cpu::executeCoreOpcode<0x2A>() // LDI A, (HL)
+{
+	_registers.A = _memory.readByte((_registers.H << 8) + _registers.L);
+	if (_registers.L == 0xFF)
+		_registers.H++;
+	_registers.L++;
+}
 
-					if (lsb)
-						setFlag(FLAG_C);
-					else
-						resetFlag(FLAG_C);
+template<> void Cpu::executeCoreOpcode<0x3A>() // LDD A, (HL)
+{
+	_registers.A = _memory.readByte((_registers.H << 8) + _registers.L);
+	_registers.L--;
+	if (_registers.L == 0xFF)
+		_registers.H--;
+}
 
-					_registers.D >>= 1;
+template<> void Cpu::executeCoreOpcode<0x02>() // LD (BC) A
+{
+	_memory.writeByte((_registers.B << 8) + _registers.C, _registers.A);			
+}
 
-					if (prevCarry)
-						_registers.D |= 0x80;
-					else
-						_registers.D &= ~0x80;
+template<> void Cpu::executeCoreOpcode<0x12>() // LD (DE) A
+{
+	_memory.writeByte((_registers.D << 8) + _registers.E, _registers.A);
+}
 
-					resetFlag(FLAG_N);
-					resetFlag(FLAG_H);
+template<> void Cpu::executeCoreOpcode<0xEA>() // LD (nn), A
+{
+	word address = _immediate;
+	_registers.pc += 2;
+	_memory.writeByte(address, _registers.A);
+}
 
-					if (_registers.D == 0x00)
-						setFlag(FLAG_Z);
-					else
-						resetFlag(FLAG_Z);
+// 16 Bit Loads
 
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x1B: // RR E
-				{
-					byte lsb = _registers.E & 0x01;
-					byte prevCarry = getFlag(FLAG_C);
+template<> void Cpu::executeCoreOpcode<0x08>() // LD nn,sp
+{
+	word address = _immediate;
+	_registers.pc += 2;
+	_memory.writeWord(address, _registers.sp);
+}
 
-					if (lsb)
-						setFlag(FLAG_C);
-					else
-						resetFlag(FLAG_C);
+template<> void Cpu::executeCoreOpcode<0xF9>() // LD sp, HL
+{
+	_registers.sp = (_registers.H << 8) + _registers.L;
+}
 
-					_registers.E >>= 1;
+template<> void Cpu::executeCoreOpcode<0x01>() // LD BC, nn
+{
+	_registers.C = immediateByte();
+	_registers.B = immediateByte();
+}
 
-					if (prevCarry)
-						_registers.E |= 0x80;
-					else
-						_registers.E &= ~0x80;
+template<> void Cpu::executeCoreOpcode<0x11>() // LD DE, nn
+{
+	_registers.E = immediateByte();
+	_registers.D = immediateByte();
+}
 
-					resetFlag(FLAG_N);
-					resetFlag(FLAG_H);
+template<> void Cpu::executeCoreOpcode<0x21>() // LD HL,nn
+{
+	_registers.L = immediateByte();
+	_registers.H = immediateByte();
+}
 
-					if (_registers.E == 0x00)
-						setFlag(FLAG_Z);
-					else
-						resetFlag(FLAG_Z);
+template<> void Cpu::executeCoreOpcode<0x31>() // LD SP,nn
+{
+	_registers.sp = _immediate;
+	_registers.pc += 2;
+}
 
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x1C: // RR H
-				{
-					byte lsb = _registers.H & 0x01;
-					byte prevCarry = getFlag(FLAG_C);
+template<> void Cpu::executeCoreOpcode<0x32>() // LDD (HL), A
+{
+	_memory.writeByte((_registers.H << 8) + _registers.L, _registers.A);
+	_registers.L--;
+	if (_registers.L == 0xFF)
+		_registers.H--;
+}
 
-					if (lsb)
-						setFlag(FLAG_C);
-					else
-						resetFlag(FLAG_C);
+template<> void Cpu::executeCoreOpcode<0xF5>() // PUSH AF
+{
+	_memory.writeByte(--_registers.sp, _registers.A);
+	_memory.writeByte(--_registers.sp, _registers.F);
+}
 
-					_registers.H >>= 1;
+template<> void Cpu::executeCoreOpcode<0xC5>() // PUSH BC
+{
+	_memory.writeByte(--_registers.sp, _registers.B);
+	_memory.writeByte(--_registers.sp, _registers.C);
+}
 
-					if (prevCarry)
-						_registers.H |= 0x80;
-					else
-						_registers.H &= ~0x80;
+template<> void Cpu::executeCoreOpcode<0xD5>() // PUSH DE
+{
+	_memory.writeByte(--_registers.sp, _registers.D);
+	_memory.writeByte(--_registers.sp, _registers.E);
+}
 
-					resetFlag(FLAG_N);
-					resetFlag(FLAG_H);
+template<> void Cpu::executeCoreOpcode<0xE5>() // PUSH HL
+{
+	_memory.writeByte(--_registers.sp, _registers.H);
+	_memory.writeByte(--_registers.sp, _registers.L);
+}
 
-					if (_registers.H == 0x00)
-						setFlag(FLAG_Z);
-					else
-						resetFlag(FLAG_Z);
+template<> void Cpu::executeCoreOpcode<0xF1>() // POP AF
+{
+	_registers.F = (_memory.readByte(_registers.sp++) & 0xF0);
+	_registers.A = _memory.readByte(_registers.sp++);
+}
 
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x1D: // RR L
-				{
-					byte lsb = _registers.L & 0x01;
-					byte prevCarry = getFlag(FLAG_C);
+template<> void Cpu::executeCoreOpcode<0xC1>() // POP BC
+{
+	_registers.C = _memory.readByte(_registers.sp++);
+	_registers.B = _memory.readByte(_registers.sp++);
+}
 
-					if (lsb)
-						setFlag(FLAG_C);
-					else
-						resetFlag(FLAG_C);
+template<> void Cpu::executeCoreOpcode<0xD1>() // POP DE
+{
+	_registers.E = _memory.readByte(_registers.sp++);
+	_registers.D = _memory.readByte(_registers.sp++);
+}
 
-					_registers.L >>= 1;
+template<> void Cpu::executeCoreOpcode<0xE1>() // POP HL
+{
+	_registers.L = _memory.readByte(_registers.sp++);
+	_registers.H = _memory.readByte(_registers.sp++);
+}
 
-					if (prevCarry)
-						_registers.L |= 0x80;
-					else
-						_registers.L &= ~0x80;
+// 16 Bit ALU
 
-					resetFlag(FLAG_N);
-					resetFlag(FLAG_H);
+template<> void Cpu::executeCoreOpcode<0x03>() // INC BC
+{
+	if (_registers.C == 0xFF)
+		_registers.B++;
+	_registers.C++;
+}
 
-					if (_registers.L == 0x00)
-						setFlag(FLAG_Z);
-					else
-						resetFlag(FLAG_Z);
+template<> void Cpu::executeCoreOpcode<0x13>() // INC DE
+{
+	if (_registers.E == 0xFF)
+		_registers.D++;
+	_registers.E++;
+}
 
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x1E: // RR (HL)
-				{
-					byte val = _memory.readByte((_registers.H << 8) + _registers.L);
-					byte lsb = val & 0x01;
-					byte prevCarry = getFlag(FLAG_C);
-
-					if (lsb)
-						setFlag(FLAG_C);
-					else
-						resetFlag(FLAG_C);
-
-					val >>= 1;
-
-					if (prevCarry)
-						val |= 0x80;
-					else
-						val &= ~0x80;
-
-					resetFlag(FLAG_N);
-					resetFlag(FLAG_H);
-
-					if (val == 0x00)
-						setFlag(FLAG_Z);
-					else
-						resetFlag(FLAG_Z);
-
-					_memory.writeByte((_registers.H << 8) + _registers.L, val);
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x0F: // RRCA
-				{
-					int carry = _registers.A & 0x01;
-
-					_registers.A >>= 1;
-
-					if (carry)
-					{
-						setFlag(FLAG_C);
-						_registers.A |= 0x80;
-					}
-					else
-					{
-						resetFlag(FLAG_C);
-					}
-
-					if (_registers.A)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-
-					resetFlag(FLAG_N);
-					resetFlag(FLAG_H);				
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x08: // RRC B
-				{
-					int carry = _registers.B & 0x01;
-
-					_registers.B >>= 1;
-
-					if (carry) 
-					{
-						setFlag(FLAG_C);
-						_registers.B |= 0x80;
-					}
-					else
-					{
-						resetFlag(FLAG_C);
-					}
-
-					if (_registers.B)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					
-					resetFlag(FLAG_N);
-					resetFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x09: // RRC C
-				{
-					int carry = _registers.C & 0x01;
-
-					_registers.C >>= 1;
-
-					if (carry)
-					{
-						setFlag(FLAG_C);
-						_registers.C |= 0x80;
-					}
-					else
-					{
-						resetFlag(FLAG_C);
-					}
-
-					if (_registers.C)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-
-					resetFlag(FLAG_N);
-					resetFlag(FLAG_H);
-				} break;
-				case 0x0A: // RRC D
-				{
-					int carry = _registers.D & 0x01;
-
-					_registers.D >>= 1;
-
-					if (carry)
-					{
-						setFlag(FLAG_C);
-						_registers.D |= 0x80;
-					}
-					else
-					{
-						resetFlag(FLAG_C);
-					}
-
-					if (_registers.D)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-
-					resetFlag(FLAG_N);
-					resetFlag(FLAG_H);
-				} break;
-				case 0x0B: // RRC E
-				{
-					int carry = _registers.E & 0x01;
-
-					_registers.E >>= 1;
-
-					if (carry)
-					{
-						setFlag(FLAG_C);
-						_registers.E |= 0x80;
-					}
-					else
-					{
-						resetFlag(FLAG_C);
-					}
-
-					if (_registers.E)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-
-					resetFlag(FLAG_N);
-					resetFlag(FLAG_H);
-				} break;
-				case 0x0C: // RRC H
-				{
-					int carry = _registers.H & 0x01;
-
-					_registers.H >>= 1;
-
-					if (carry)
-					{
-						setFlag(FLAG_C);
-						_registers.H |= 0x80;
-					}
-					else
-					{
-						resetFlag(FLAG_C);
-					}
-
-					if (_registers.H)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-
-					resetFlag(FLAG_N);
-					resetFlag(FLAG_H);
-				} break;
-				case 0x0D: // RRC L
-				{
-					int carry = _registers.L & 0x01;
-
-					_registers.L >>= 1;
-
-					if (carry)
-					{
-						setFlag(FLAG_C);
-						_registers.L |= 0x80;
-					}
-					else
-					{
-						resetFlag(FLAG_C);
-					}
-
-					if (_registers.L)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-
-					resetFlag(FLAG_N);
-					resetFlag(FLAG_H);
-				} break;
-				case 0x0E: // RRC (HL)
-				{
-					byte val = _memory.readByte((_registers.H << 8) + _registers.L);
-					
-					int carry = val & 0x01;
-					val >>= 1;
-
-					if (carry)
-					{
-						setFlag(FLAG_C);
-						val |= 0x80;
-					}
-					else
-					{
-						resetFlag(FLAG_C);
-					}
-
-					if (val)					
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-
-					resetFlag(FLAG_N);
-					resetFlag(FLAG_H);
-
-					_memory.writeByte((_registers.H << 8) + _registers.L, val);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x07: // RLC A
-				{
-					int carry = (_registers.A & 0x80) >> 7;
-
-					if (_registers.A & 0x80) 
-						setFlag(FLAG_C);
-					else
-						resetFlag(FLAG_C);					
-
-					_registers.A <<= 1;
-					_registers.A += carry;
-
-					if (_registers.A)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-					
-					resetFlag(FLAG_N);
-					resetFlag(FLAG_H);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x00: // RLC B
-				{
-					int carry = (_registers.B & 0x80) >> 7;
+template<> void Cpu::executeCoreOpcode<0x23>() // INC HL
+{
+	if (_registers.L == 0xFF)
+		_registers.H++;
+	_registers.L++;
+}
 
-					if (_registers.B & 0x80) 
-						setFlag(FLAG_C);
-					else 
-						resetFlag(FLAG_C);
+template<> void Cpu::executeCoreOpcode<0x33>() // INC SP
+{
+	_registers.sp++;
+}
 
-					_registers.B <<= 1;
-					_registers.B += carry;
+template<> void Cpu::executeCoreOpcode<0x0B>() // DEC BC
+{
+	if (_registers.C == 0x00)
+		_registers.B--;
+	_registers.C--;
+}
 
-					if (_registers.B) 
-						resetFlag(FLAG_Z);
-					else 
-						setFlag(FLAG_Z);
+template<> void Cpu::executeCoreOpcode<0x1B>() // DEC DE
+{
+	if (_registers.E == 0x00)
+		_registers.D--;
+	_registers.E--;
+}
 
-					resetFlag(FLAG_N);
-					resetFlag(FLAG_H);
+template<> void Cpu::executeCoreOpcode<0x2B>() // DEC HL
+{
+	if (_registers.L == 0x00)
+		_registers.H--;
+	_registers.L--;
+}
 
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x01: // RLC C
-				{
-					int carry = (_registers.C & 0x80) >> 7;
+template<> void Cpu::executeCoreOpcode<0x3B>() // DEC SP
+{
+	_registers.sp--;
+}
 
-					if (_registers.C & 0x80)
-						setFlag(FLAG_C);
-					else
-						resetFlag(FLAG_C);
+template<> void Cpu::executeCoreOpcode<0x09>() // ADD HL, BC
+{
+	int BC = (_registers.B << 8) + _registers.C;
+	int HL = (_registers.H << 8) + _registers.L;
+	int res = HL + BC;
 
-					_registers.C <<= 1;
-					_registers.C += carry;
+	if (res & 0xFFFF0000)
+		setFlag(FLAG_C);
+	else
+		resetFlag(FLAG_C);
 
-					if (_registers.C)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
+	if (0xFFF - (HL & 0xFFF) < (BC & 0xFFF))
+		setFlag(FLAG_H);
+	else
+		resetFlag(FLAG_H);
 
-					resetFlag(FLAG_N);
-					resetFlag(FLAG_H);
+	HL += BC;
 
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x02: // RLC D
-				{
-					int carry = (_registers.D & 0x80) >> 7;
+	_registers.H = (HL >> 8) & 0xFF;
+	_registers.L = HL & 0xFF;
 
-					if (_registers.D & 0x80)
-						setFlag(FLAG_C);
-					else
-						resetFlag(FLAG_C);
+	resetFlag(FLAG_N);
+}
 
-					_registers.D <<= 1;
-					_registers.D += carry;
+template<> void Cpu::executeCoreOpcode<0x19>() // ADD HL, DE
+{
+	int DE = (_registers.D << 8) + _registers.E;
+	int HL = (_registers.H << 8) + _registers.L;
+	int res = HL + DE;
 
-					if (_registers.D)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
+	if (res & 0xFFFF0000)
+		setFlag(FLAG_C);
+	else
+		resetFlag(FLAG_C);
 
-					resetFlag(FLAG_N);
-					resetFlag(FLAG_H);
+	if (0xFFF - (HL & 0xFFF) < (DE & 0xFFF))
+		setFlag(FLAG_H);
+	else
+		resetFlag(FLAG_H);
 
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x03: // RLC E
-				{
-					int carry = (_registers.E & 0x80) >> 7;
+	HL += DE;
 
-					if (_registers.E & 0x80)
-						setFlag(FLAG_C);
-					else
-						resetFlag(FLAG_C);
+	_registers.H = (HL >> 8) & 0xFF;
+	_registers.L = HL & 0xFF;
 
-					_registers.E <<= 1;
-					_registers.E += carry;
+	resetFlag(FLAG_N);
+}
 
-					if (_registers.E)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
+template<> void Cpu::executeCoreOpcode<0x29>() // ADD HL, HL
+{
+	int HL2 = (_registers.H << 8) + _registers.L;
+	int HL = (_registers.H << 8) + _registers.L;
+	int res = HL + HL2;
 
-					resetFlag(FLAG_N);
-					resetFlag(FLAG_H);
+	if (res & 0xFFFF0000)
+		setFlag(FLAG_C);
+	else
+		resetFlag(FLAG_C);
 
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x04: // RLC H
-				{
-					int carry = (_registers.H & 0x80) >> 7;
+	if (0xFFF - (HL & 0xFFF) < (HL2 & 0xFFF))
+		setFlag(FLAG_H);
+	else
+		resetFlag(FLAG_H);
 
-					if (_registers.H & 0x80)
-						setFlag(FLAG_C);
-					else
-						resetFlag(FLAG_C);
+	HL += HL2;
 
-					_registers.H <<= 1;
-					_registers.H += carry;
+	_registers.H = (HL >> 8) & 0xFF;
+	_registers.L = HL & 0xFF;
 
-					if (_registers.H)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
+	resetFlag(FLAG_N);
+}
 
-					resetFlag(FLAG_N);
-					resetFlag(FLAG_H);
+template<> void Cpu::executeCoreOpcode<0x39>() // ADD HL, SP
+{
+	int SP = _registers.sp;
+	int HL = (_registers.H << 8) + _registers.L;
+	int res = HL + SP;
 
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x05: // RLC L
-				{
-					int carry = (_registers.L & 0x80) >> 7;
+	if (res & 0xFFFF0000)
+		setFlag(FLAG_C);
+	else
+		resetFlag(FLAG_C);
 
-					if (_registers.L & 0x80)
-						setFlag(FLAG_C);
-					else
-						resetFlag(FLAG_C);
+	if (0xFFF - (HL & 0xFFF) < (SP & 0xFFF))
+		setFlag(FLAG_H);
+	else
+		resetFlag(FLAG_H);
 
-					_registers.L <<= 1;
-					_registers.L += carry;
+	HL += SP;
 
-					if (_registers.L)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
+	_registers.H = (HL >> 8) & 0xFF;
+	_registers.L = HL & 0xFF;
 
-					resetFlag(FLAG_N);
-					resetFlag(FLAG_H);
+	resetFlag(FLAG_N);
+}
 
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x06: // RLC (HL)
-				{
-					byte val = _memory.readByte((_registers.H << 8) + _registers.L);
-
-					int carry = (val & 0x80) >> 7;
-					
-					if (val & 0x80)
-						setFlag(FLAG_C);
-					else
-						resetFlag(FLAG_C);
-
-					val <<= 1;
-					val += carry;
-
-					resetFlag(FLAG_N);
-					resetFlag(FLAG_H);
-
-					if (val)
-						resetFlag(FLAG_Z);
-					else
-						setFlag(FLAG_Z);
-
-					resetFlag(FLAG_N);
-					resetFlag(FLAG_H);					
-					
-					_memory.writeByte((_registers.H << 8) + _registers.L, val);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				// Sets
-				case 0xC7: // SET 0, A
-				{
-					_registers.A |= 0x01;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xCF: // SET 1, A
-				{
-					_registers.A |= 0x02;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xD7: // SET 2, A
-				{
-					_registers.A |= 0x04;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xDF: // SET 3, A
-				{
-					_registers.A |= 0x08;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xE7: // SET 4, A
-				{
-					_registers.A |= 0x10;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xEF: // SET 5, A
-				{
-					_registers.A |= 0x20;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xF7: // SET 6, A
-				{
-					_registers.A |= 0x40;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xFF: // SET 7, A
-				{
-					_registers.A |= 0x80;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xC0: // SET 0, B
-				{
-					_registers.B |= 0x01;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xC8: // SET 1, B
-				{
-					_registers.B |= 0x02;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xD0: // SET 2, B
-				{
-					_registers.B |= 0x04;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xD8: // SET 3, B
-				{
-					_registers.B |= 0x08;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xE0: // SET 4, B
-				{
-					_registers.B |= 0x10;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xE8: // SET 5, B
-				{
-					_registers.B |= 0x20;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xF0: // SET 6, B
-				{
-					_registers.B |= 0x40;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xF8: // SET 7, B
-				{
-					_registers.B |= 0x80;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xC1: // SET 0, C
-				{
-					_registers.C |= 0x01;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xC9: // SET 1, C
-				{
-					_registers.C |= 0x02;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xD1: // SET 2, C
-				{
-					_registers.C |= 0x04;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xD9: // SET 3, C
-				{
-					_registers.C |= 0x08;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xE1: // SET 4, C
-				{
-					_registers.C |= 0x10;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xE9: // SET 5, C
-				{
-					_registers.C |= 0x20;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xF1: // SET 6, C
-				{
-					_registers.C |= 0x40;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xF9: // SET 7, C
-				{
-					_registers.C |= 0x80;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xC2: // SET 0, D
-				{
-					_registers.D |= 0x01;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xCA: // SET 1, D
-				{
-					_registers.D |= 0x02;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xD2: // SET 2, D
-				{
-					_registers.D |= 0x04;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xDA: // SET 3, D
-				{
-					_registers.D |= 0x08;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xE2: // SET 4, D
-				{
-					_registers.D |= 0x10;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xEA: // SET 5, D
-				{
-					_registers.D |= 0x20;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xF2: // SET 6, D
-				{
-					_registers.D |= 0x40;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xFA: // SET 7, D
-				{
-					_registers.D |= 0x80;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xC3: // SET 0, E
-				{
-					_registers.E |= 0x01;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xCB: // SET 1, E
-				{
-					_registers.E |= 0x02;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xD3: // SET 2, E
-				{
-					_registers.E |= 0x04;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xDB: // SET 3, E
-				{
-					_registers.E |= 0x08;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xE3: // SET 4, E
-				{
-					_registers.E |= 0x10;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xEB: // SET 5, E
-				{
-					_registers.E |= 0x20;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xF3: // SET 6, E
-				{
-					_registers.E |= 0x40;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xFB: // SET 7, E
-				{
-					_registers.E |= 0x80;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xC4: // SET 0, H
-				{
-					_registers.H |= 0x01;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xCC: // SET 1, H
-				{
-					_registers.H |= 0x02;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xD4: // SET 2, H
-				{
-					_registers.H |= 0x04;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xDC: // SET 3, H
-				{
-					_registers.H |= 0x08;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xE4: // SET 4, H
-				{
-					_registers.H |= 0x10;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xEC: // SET 5, H
-				{
-					_registers.H |= 0x20;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xF4: // SET 6, H
-				{
-					_registers.H |= 0x40;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xFC: // SET 7, H
-				{
-					_registers.H |= 0x80;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xC5: // SET 0, L
-				{
-					_registers.L |= 0x01;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xCD: // SET 1, L
-				{
-					_registers.L |= 0x02;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xD5: // SET 2, L
-				{
-					_registers.L |= 0x04;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xDD: // SET 3, L
-				{
-					_registers.L |= 0x08;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xE5: // SET 4, L
-				{
-					_registers.L |= 0x10;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xED: // SET 5,L
-				{
-					_registers.L |= 0x20;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xF5: // SET 6, L
-				{
-					_registers.L |= 0x40;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xFD: // SET 7, L
-				{
-					_registers.L |= 0x80;
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xC6: // SET 0, (HL)
-				{
-					byte nextByte = _memory.readByte((_registers.H << 8) + _registers.L);
-					nextByte |= 0x01;
-					_memory.writeByte((_registers.H << 8) + _registers.L, nextByte);
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xCE: // SET 1, (HL)
-				{
-					byte nextByte = _memory.readByte((_registers.H << 8) + _registers.L);
-					nextByte |= 0x02;
-					_memory.writeByte((_registers.H << 8) + _registers.L, nextByte);
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xD6: // SET 2, (HL)
-				{
-					byte nextByte = _memory.readByte((_registers.H << 8) + _registers.L);
-					nextByte |= 0x04;
-					_memory.writeByte((_registers.H << 8) + _registers.L, nextByte);
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xDE: // SET 3, (HL)
-				{
-					byte nextByte = _memory.readByte((_registers.H << 8) + _registers.L);
-					nextByte |= 0x08;
-					_memory.writeByte((_registers.H << 8) + _registers.L, nextByte);
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xE6: // SET 4, (HL)
-				{
-					byte nextByte = _memory.readByte((_registers.H << 8) + _registers.L);
-					nextByte |= 0x10;
-					_memory.writeByte((_registers.H << 8) + _registers.L, nextByte);
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xEE: // SET 5, (HL)
-				{
-					byte nextByte = _memory.readByte((_registers.H << 8) + _registers.L);
-					nextByte |= 0x20;
-					_memory.writeByte((_registers.H << 8) + _registers.L, nextByte);
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0xF6: // SET 6, (HL)
-				{
-					byte nextByte = _memory.readByte((_registers.H << 8) + _registers.L);
-					nextByte |= 0x40;
-					_memory.writeByte((_registers.H << 8) + _registers.L, nextByte);
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;				
-				case 0xFE: // SET 7, (HL)
-				{
-					byte nextByte = _memory.readByte((_registers.H << 8) + _registers.L);
-					nextByte |= 0x80;
-					_memory.writeByte((_registers.H << 8) + _registers.L, nextByte);
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-
-				// Shifts
-				case 0x27: // SLA A
-				{
-					if ((_registers.A & 0x80) != 0)
-						setFlag(FLAG_C);
-					else
-						resetFlag(FLAG_C);
-
-					_registers.A <<= 1;
-					_registers.A &= ~0x01;
-
-					resetFlag(FLAG_N);
-					resetFlag(FLAG_H);
-
-					if (_registers.A == 0x00)
-						setFlag(FLAG_Z);
-					else
-						resetFlag(FLAG_Z);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x20: // SLA B
-				{
-					if ((_registers.B & 0x80) != 0)
-						setFlag(FLAG_C);
-					else
-						resetFlag(FLAG_C);
-
-					_registers.B <<= 1;
-					_registers.B &= ~0x01;
-
-					resetFlag(FLAG_N);
-					resetFlag(FLAG_H);
-
-					if (_registers.B == 0x00)
-						setFlag(FLAG_Z);
-					else
-						resetFlag(FLAG_Z);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x21: // SLA C
-				{
-					if ((_registers.C & 0x80) != 0)
-						setFlag(FLAG_C);
-					else
-						resetFlag(FLAG_C);
-
-					_registers.C <<= 1;
-					_registers.C &= ~0x01;
-
-					resetFlag(FLAG_N);
-					resetFlag(FLAG_H);
-
-					if (_registers.C == 0x00)
-						setFlag(FLAG_Z);
-					else
-						resetFlag(FLAG_Z);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x22: // SLA D
-				{
-					if ((_registers.D & 0x80) != 0)
-						setFlag(FLAG_C);
-					else
-						resetFlag(FLAG_C);
-
-					_registers.D <<= 1;
-					_registers.D &= ~0x01;
-
-					resetFlag(FLAG_N);
-					resetFlag(FLAG_H);
-
-					if (_registers.D == 0x00)
-						setFlag(FLAG_Z);
-					else
-						resetFlag(FLAG_Z);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x23: // SLA E
-				{
-					if ((_registers.E & 0x80) != 0)
-						setFlag(FLAG_C);
-					else
-						resetFlag(FLAG_C);
-
-					_registers.E <<= 1;
-					_registers.E &= ~0x01;
-
-					resetFlag(FLAG_N);
-					resetFlag(FLAG_H);
-
-					if (_registers.E == 0x00)
-						setFlag(FLAG_Z);
-					else
-						resetFlag(FLAG_Z);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x24: // SLA H
-				{
-					if ((_registers.H & 0x80) != 0)
-						setFlag(FLAG_C);
-					else
-						resetFlag(FLAG_C);
-
-					_registers.H <<= 1;
-					_registers.H &= ~0x01;
-
-					resetFlag(FLAG_N);
-					resetFlag(FLAG_H);
-
-					if (_registers.H == 0x00)
-						setFlag(FLAG_Z);
-					else
-						resetFlag(FLAG_Z);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x25: // SLA L
-				{
-					if ((_registers.L & 0x80) != 0)
-						setFlag(FLAG_C);
-					else
-						resetFlag(FLAG_C);
-
-					_registers.L <<= 1;
-					_registers.L &= ~0x01;
-
-					resetFlag(FLAG_N);
-					resetFlag(FLAG_H);
-
-					if (_registers.L == 0x00)
-						setFlag(FLAG_Z);
-					else
-						resetFlag(FLAG_Z);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x26: // SLA (HL)
-				{
-					byte val = _memory.readByte((_registers.H << 8) + _registers.L);
-					if ((val & 0x80) != 0)
-						setFlag(FLAG_C);
-					else
-						resetFlag(FLAG_C);
+template<> void Cpu::executeCoreOpcode<0xE8>() // ADD SP, n
+{
+	signed char val = immediateByte();
+	int result = _registers.sp + val;
 
-					val <<= 1;
-					val &= ~0x01;
+	// Gearboy saves the day again
+	if (((_registers.sp ^ val ^ result) & 0x100) == 0x100)
+		setFlag(FLAG_C);
+	else
+		resetFlag(FLAG_C);
 
-					resetFlag(FLAG_N);
-					resetFlag(FLAG_H);
+	if (((_registers.sp ^ val ^ result) & 0x10) == 0x10)
+		setFlag(FLAG_H);
+	else
+		resetFlag(FLAG_H);
 
-					if (val == 0x00)
-						setFlag(FLAG_Z);
-					else
-						resetFlag(FLAG_Z);
+	_registers.sp += val;
 
-					_memory.writeByte((_registers.H << 8) + _registers.L, val);
+	resetFlag(FLAG_Z);
+	resetFlag(FLAG_N);
+}
 
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x2F: // SRA A
-				{
-					byte msb = _registers.A & 0x80;
-					byte lsb = _registers.A & 0x01;
+// Rotates & Shifts
+
+template<> void Cpu::executeCoreOpcode<0x0F>() // RRCA
+{
+	if ((_registers.A & 0x01) != 0)
+	{
+		_registers.A >>= 1;
+		_registers.A |= 0x80;
+		setFlag(FLAG_C);
+	}
+	else
+	{
+		_registers.A >>= 1;
+		resetFlag(FLAG_C);
+	}
+
+	resetFlag(FLAG_Z);
+	resetFlag(FLAG_H);
+	resetFlag(FLAG_N);
+}
+
+template<> void Cpu::executeCoreOpcode<0x17>() // RLA
+{
+	int carry = isFlagSet(FLAG_C) ? 1 : 0;
 
-					if (lsb)
-						setFlag(FLAG_C);
-					else
-						resetFlag(FLAG_C);
+	if (_registers.A & 0x80)
+		setFlag(FLAG_C);
+	else
+		resetFlag(FLAG_C);
 
-					resetFlag(FLAG_H);
-					resetFlag(FLAG_N);
+	_registers.A <<= 1;
+	_registers.A += carry;
 
-					_registers.A >>= 1;
+	resetFlag(FLAG_N);
+	resetFlag(FLAG_Z);
+	resetFlag(FLAG_H);
+}
 
-					if (msb)
-						_registers.A |= 0x80;
-					else
-						_registers.A &= ~0x80;
+template<> void Cpu::executeCoreOpcode<0x1F>() // RRA
+{
+	int carry = (isFlagSet(FLAG_C) ? 1 : 0) << 7;
 
-					if (_registers.A == 0x00)
-						setFlag(FLAG_Z);
-					else
-						resetFlag(FLAG_Z);
+	if (_registers.A & 0x01) 
+		setFlag(FLAG_C);
+	else
+		resetFlag(FLAG_C);
 
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x28: // SRA B
-				{
-					byte msb = _registers.B & 0x80;
-					byte lsb = _registers.B & 0x01;
+	_registers.A >>= 1;
+	_registers.A += carry;
 
-					if (lsb)
-						setFlag(FLAG_C);
-					else
-						resetFlag(FLAG_C);
+	resetFlag(FLAG_N);
+	resetFlag(FLAG_Z);
+	resetFlag(FLAG_H);
+}
 
-					resetFlag(FLAG_H);
-					resetFlag(FLAG_N);
+template<> void Cpu::executeCoreOpcode<0x07>() // RLCA
+{
+	byte carry = (_registers.A & 0x80) >> 7;
+	if (carry) 
+		setFlag(FLAG_C);
+	else
+		resetFlag(FLAG_C);
 
-					_registers.B >>= 1;
+	_registers.A <<= 1;
+	_registers.A += carry;
 
-					if (msb)
-						_registers.B |= 0x80;
-					else
-						_registers.B &= ~0x80;
+	resetFlag(FLAG_N);
+	resetFlag(FLAG_Z);
+	resetFlag(FLAG_H);
+}
 
-					if (_registers.B == 0x00)
-						setFlag(FLAG_Z);
-					else
-						resetFlag(FLAG_Z);
+// Calls
 
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x29: // SRA C
-				{
-					byte msb = _registers.C & 0x80;
-					byte lsb = _registers.C & 0x01;
+template<> void Cpu::executeCoreOpcode<0xCD>() // Call nn
+{
+	_registers.sp -= 2;
+	_memory.writeWord(_registers.sp, _registers.pc + 2);
+	_registers.pc = _immediate;
+}
 
-					if (lsb)
-						setFlag(FLAG_C);
-					else
-						resetFlag(FLAG_C);
+template<> void Cpu::executeCoreOpcode<0xC4>() // CALL NZ, nn
+{
+	if (!isFlagSet(FLAG_Z)) 
+	{
+		_registers.sp -= 2;
+		_memory.writeWord(_registers.sp, _registers.pc + 2);
+		_registers.pc = _immediate;
+		_registers.M += 2;
+		_registers.T += 8; 
+	}
+	else 
+		_registers.pc += 2;
+}
+
+template<> void Cpu::executeCoreOpcode<0xCC>() // CALL Z, nn
+{
+	if (isFlagSet(FLAG_Z))
+	{
+		_registers.sp -= 2;
+		_memory.writeWord(_registers.sp, _registers.pc + 2);
+		_registers.pc = _immediate;
+		_registers.M += 2;
+		_registers.T += 8;
+	}
+	else
+		_registers.pc += 2;
+}
+
+template<> void Cpu::executeCoreOpcode<0xD4>() // CALL NC, nn
+{
+	if (!isFlagSet(FLAG_C))
+	{
+		_registers.sp -= 2;
+		_memory.writeWord(_registers.sp, _registers.pc + 2);
+		_registers.pc = _immediate;
+		_registers.M += 2;
+		_registers.T += 8;
+	}
+	else
+		_registers.pc += 2;
+}
+
+template<> void Cpu::executeCoreOpcode<0xDC>() // CALL C, nn
+{
+	if (isFlagSet(FLAG_C))
+	{
+		_registers.sp -= 2;
+		_memory.writeWord(_registers.sp, _registers.pc + 2);
+		_registers.pc = _immediate;
+		_registers.M += 2;
+		_registers.T += 8;
+	}
+	else
+		_registers.pc += 2;
+}
+
+// Jumps
+
+template<> void Cpu::executeCoreOpcode<0x10>() // DJNZn
+{
+	signed char i = immediateByte();
+	_registers.B--;
+
+	if (_registers.B != 0)
+	{
+		_registers.pc += i;
+		_registers.M ++;
+	}
+}
+
+template<> void Cpu::executeCoreOpcode<0xC3>() // JP nn
+{
+	takeBranch(_registers.pc - 1, _immediate);
+}
 
-					resetFlag(FLAG_H);
-					resetFlag(FLAG_N);
+template<> void Cpu::executeCoreOpcode<0xE9>() // JP (HL)
+{
+	_registers.pc = (_registers.H << 8) + _registers.L;
+}
 
-					_registers.C >>= 1;
+template<> void Cpu::executeCoreOpcode<0xC2>() // JP NZ, nn
+{
+	if (!isFlagSet(FLAG_Z))
+	{
+		takeBranch(_registers.pc - 1, _immediate);
+		_registers.M++;
+		_registers.T += 4;
+	}
+	else
+	{
+		_registers.pc += 2;
+	}
+}
 
-					if (msb)
-						_registers.C |= 0x80;
-					else
-						_registers.C &= ~0x80;
+template<> void Cpu::executeCoreOpcode<0xCA>() // JP Z, nn
+{
+	if (isFlagSet(FLAG_Z))
+	{
+		takeBranch(_registers.pc - 1, _immediate);
+		_registers.M++;
+		_registers.T += 4;
+	}
+	else
+	{
+		_registers.pc += 2;
+	}
+}
 
-					if (_registers.C == 0x00)
-						setFlag(FLAG_Z);
-					else
-						resetFlag(FLAG_Z);
+template<> void Cpu::executeCoreOpcode<0xD2>() // JP NC, nn
+{
+	if (!isFlagSet(FLAG_C))
+	{
+		takeBranch(_registers.pc - 1, _immediate);
+		_registers.M++;
+		_registers.T += 4;
+	}
+	else
+	{
+		_registers.pc += 2;
+	}
+}
 
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x2A: // SRA D
-				{
-					byte msb = _registers.D & 0x80;
-					byte lsb = _registers.D & 0x01;
+template<> void Cpu::executeCoreOpcode<0xDA>() // JP C, nn
+{
+	if (isFlagSet(FLAG_C))
+	{
+		takeBranch(_registers.pc - 1, _immediate);
+		_registers.M++;
+		_registers.T += 4;
+	}
+	else
+	{
+		_registers.pc += 2;
+	}
+}
 
-					if (lsb)
-						setFlag(FLAG_C);
-					else
-						resetFlag(FLAG_C);
+template<> void Cpu::executeCoreOpcode<0x18>() // JR n
+{
+	signed char n = immediateByte();
+	takeBranch(_registers.pc - 2, static_cast<word>(_registers.pc + n));
+	_registers.M++;
+	_registers.T += 4;
+}
 
-					resetFlag(FLAG_H);
-					resetFlag(FLAG_N);
+template<> void Cpu::executeCoreOpcode<0x20>() // JR NZ,n
+{
+	signed char nextByte = immediateByte();
+	if (!isFlagSet(FLAG_Z))
+	{
+		takeBranch(_registers.pc - 2, static_cast<word>(_registers.pc + nextByte));
+		_registers.M++; 
+		_registers.T += 4;
+	}
+}
 
-					_registers.D >>= 1;
+template<> void Cpu::executeCoreOpcode<0x28>() // JR Z,n
+{
+	signed char nextByte = immediateByte();
+	if (isFlagSet(FLAG_Z))
+	{
+		takeBranch(_registers.pc - 2, static_cast<word>(_registers.pc + nextByte));
+		_registers.M++;
+		_registers.T += 4;
+	}
+}
 
-					if (msb)
-						_registers.D |= 0x80;
-					else
-						_registers.D &= ~0x80;
+template<> void Cpu::executeCoreOpcode<0x30>() // JR NC,n
+{
+	signed char nextByte = immediateByte();
+	if (!isFlagSet(FLAG_C))
+	{
+		takeBranch(_registers.pc - 2, static_cast<word>(_registers.pc + nextByte));
+		_registers.M++;
+		_registers.T += 4;
+	}
+}
 
-					if (_registers.D == 0x00)
-						setFlag(FLAG_Z);
-					else
-						resetFlag(FLAG_Z);
+template<> void Cpu::executeCoreOpcode<0x38>() // JR C,n
+{
+	signed char nextByte = immediateByte();
+	if (isFlagSet(FLAG_C))
+	{
+		takeBranch(_registers.pc - 2, static_cast<word>(_registers.pc + nextByte));
+		_registers.M++;
+		_registers.T += 4;
+	}
+}
 
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x2B: // SRA E
-				{
-					byte msb = _registers.E & 0x80;
-					byte lsb = _registers.E & 0x01;
+void Cpu::takeBranch(const word branchAddress, const word target)
+{
+	_registers.pc = target;
 
-					if (lsb)
-						setFlag(FLAG_C);
-					else
-						resetFlag(FLAG_C);
+	// Only backward branches can close a loop
+	if (target <= branchAddress)
+		checkPollingLoop(branchAddress);
+}
 
-					resetFlag(FLAG_H);
-					resetFlag(FLAG_N);
+// Returns
 
-					_registers.E >>= 1;
+template<> void Cpu::executeCoreOpcode<0xC9>() // RET
+{
+	_registers.pc = _memory.readWord(_registers.sp);
+	_registers.sp += 2;
+}
 
-					if (msb)
-						_registers.E |= 0x80;
-					else
-						_registers.E &= ~0x80;
+template<> void Cpu::executeCoreOpcode<0xC0>() // RET NZ
+{
+	if (!isFlagSet(FLAG_Z))
+	{
+		_registers.pc = _memory.readWord(_registers.sp);
+		_registers.sp += 2;
+	}
+}
 
-					if (_registers.E == 0x00)
-						setFlag(FLAG_Z);
-					else
-						resetFlag(FLAG_Z);
+template<> void Cpu::executeCoreOpcode<0xC8>() // RET Z
+{
+	if (isFlagSet(FLAG_Z))
+	{
+		_registers.pc = _memory.readWord(_registers.sp);
+		_registers.sp += 2;
+	}
+}
 
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x2C: // SRA H
-				{
-					byte msb = _registers.H & 0x80;
-					byte lsb = _registers.H & 0x01;
+template<> void Cpu::executeCoreOpcode<0xD0>() // RET NC
+{
+	if (!isFlagSet(FLAG_C))
+	{
+		_registers.pc = _memory.readWord(_registers.sp);
+		_registers.sp += 2;
+	}
+}
 
-					if (lsb)
-						setFlag(FLAG_C);
-					else
-						resetFlag(FLAG_C);
+template<> void Cpu::executeCoreOpcode<0xD8>() // RET C
+{
+	if (isFlagSet(FLAG_C))
+	{
+		_registers.pc = _memory.readWord(_registers.sp);
+		_registers.sp += 2;
+	}
+}
 
-					resetFlag(FLAG_H);
-					resetFlag(FLAG_N);
+template<> void Cpu::executeCoreOpcode<0xD9>() // RETI
+{
+	setIME(1);
 
-					_registers.H >>= 1;
+	_registers.pc = _memory.readWord(_registers.sp);
+	_registers.sp += 2;
+}
 
-					if (msb)
-						_registers.H |= 0x80;
-					else
-						_registers.H &= ~0x80;
+// Misc
 
-					if (_registers.H == 0x00)
-						setFlag(FLAG_Z);
-					else
-						resetFlag(FLAG_Z);
+template<> void Cpu::executeCoreOpcode<0x76>() // HALT
+{
+	// Wait for an enabled interrupt, one that is already pending ends the HALT straight away
+	if (*_raisedInterrupts == 0)
+		_halted = true;
+}
 
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x2D: // SRA L
-				{
-					byte msb = _registers.L & 0x80;
-					byte lsb = _registers.L & 0x01;
+template<> void Cpu::executeCoreOpcode<0x27>() // DAA
+{
+	const word entry = s_daaTable[(_registers.F & (FLAG_N | FLAG_H | FLAG_C)) << 4 | _registers.A];
 
-					if (lsb)
-						setFlag(FLAG_C);
-					else
-						resetFlag(FLAG_C);
+	_registers.A = entry >> 8;
+	_registers.F = entry & 0xFF;
+}
 
-					resetFlag(FLAG_H);
-					resetFlag(FLAG_N);
+template<> void Cpu::executeCoreOpcode<0xF3>() // DI
+{
+	setIME(0);
+}
 
-					_registers.L >>= 1;
+template<> void Cpu::executeCoreOpcode<0xFB>() // EI
+{
+	setIME(1);
+}
 
-					if (msb)
-						_registers.L |= 0x80;
-					else
-						_registers.L &= ~0x80;
+// Restarts
 
-					if (_registers.L == 0x00)
-						setFlag(FLAG_Z);
-					else
-						resetFlag(FLAG_Z);
+template<> void Cpu::executeCoreOpcode<0xC7>() // RST 0x00
+{
+	_registers.sp -= 2;
+	_memory.writeWord(_registers.sp, _registers.pc);
+	_registers.pc = 0x00;
+}
 
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x2E: // SRA (HL)
-				{
-					byte val = _memory.readByte((_registers.H << 8) + _registers.L);
-					byte msb = val & 0x80;
-					byte lsb = val & 0x01;
+template<> void Cpu::executeCoreOpcode<0xCF>() // RST 0x08
+{
+	_registers.sp -= 2;
+	_memory.writeWord(_registers.sp, _registers.pc);
+	_registers.pc = 0x08;
+}
 
-					if (lsb)
-						setFlag(FLAG_C);
-					else
-						resetFlag(FLAG_C);
+template<> void Cpu::executeCoreOpcode<0xD7>() // RST 0x10
+{
+	_registers.sp -= 2;
+	_memory.writeWord(_registers.sp, _registers.pc);
+	_registers.pc = 0x10;
+}
 
-					resetFlag(FLAG_H);
-					resetFlag(FLAG_N);
+template<> void Cpu::executeCoreOpcode<0xDF>() // RST 0x18
+{
+	_registers.sp -= 2;
+	_memory.writeWord(_registers.sp, _registers.pc);
+	_registers.pc = 0x18;
+}
 
-					val >>= 1;
+template<> void Cpu::executeCoreOpcode<0xE7>() // RST 0x20
+{
+	_registers.sp -= 2;
+	_memory.writeWord(_registers.sp, _registers.pc);
+	_registers.pc = 0x20;
+}
 
-					if (msb)
-						val |= 0x80;
-					else
-						val &= ~0x80;
+template<> void Cpu::executeCoreOpcode<0xEF>() // RST 0x28
+{
+	_registers.sp -= 2;
+	_memory.writeWord(_registers.sp, _registers.pc);
+	_registers.pc = 0x28;
+}
 
-					if (val == 0x00)
-						setFlag(FLAG_Z);
-					else
-						resetFlag(FLAG_Z);
+template<> void Cpu::executeCoreOpcode<0xF7>() // RST 0x30
+{
+	_registers.sp -= 2;
+	_memory.writeWord(_registers.sp, _registers.pc);
+	_registers.pc = 0x30;
+}
 
-					_memory.writeByte((_registers.H << 8) + _registers.L, val);
+template<> void Cpu::executeCoreOpcode<0xFF>() // RST 0x38
+{
+	_registers.sp -= 2;
+	_memory.writeWord(_registers.sp, _registers.pc);
+	_registers.pc = 0x38;
+}
 
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x3F: // SRL A
-				{
-					byte prevBit = _registers.A & 0x01;
+template<> void Cpu::executeCoreOpcode<0x2F>() // CPL
+{
+	_registers.A = ~_registers.A;
+	setFlag(FLAG_N);
+	setFlag(FLAG_H);
+}
 
-					_registers.A >>= 1;
+template<> void Cpu::executeCoreOpcode<0x37>() // SCF
+{
+	setFlag(FLAG_C);
+	resetFlag(FLAG_N);
+	resetFlag(FLAG_H);
+}
 
-					_registers.A &= ~0x80;
+template<> void Cpu::executeCoreOpcode<0x3F>() // CCF
+{
+	if (isFlagSet(FLAG_C))
+		resetFlag(FLAG_C);
+	else
+		setFlag(FLAG_C);
 
-					if (prevBit)
-						setFlag(FLAG_C);
-					else
-						resetFlag(FLAG_C);
+	resetFlag(FLAG_N);
+	resetFlag(FLAG_H);
+}
 
-					if (_registers.A == 0x00)
-						setFlag(FLAG_Z);
-					else
-						resetFlag(FLAG_Z);
+// CB
 
-					resetFlag(FLAG_N);
-					resetFlag(FLAG_H);
+// Decoded blocks resolve the prefix up front, this only runs for CB dispatched through the core table
+template<> void Cpu::executeCoreOpcode<0xCB>()
+{
+	_opcode      = immediateByte();
+	_isBitOpcode = true;
 
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
+	const opcode_entry& entry = s_cbOpcodes[_opcode];
+	_registers.M = entry.m;
+	_registers.T = entry.t;
+	(this->*entry.handler)();
+}
 
-				} break;
+template<byte opcode>
+void Cpu::callCoreOpcode(Cpu* cpu)
+{
+	cpu->executeCoreOpcode<opcode>();
+}
 
-				case 0x38: // SRL B
-				{
-					byte prevBit = _registers.B & 0x01;
+template<byte opcode>
+void Cpu::callCbOpcode(Cpu* cpu)
+{
+	cpu->executeCbOpcode<opcode>();
+}
 
-					_registers.B >>= 1;
+// Dispatch tables: one handler per opcode with its cycle cost folded in
+#define CORE_OPCODE(op) { &Cpu::executeCoreOpcode<op>, &Cpu::callCoreOpcode<op>, static_cast<byte>(coreInstructionTicks[op] / 2), static_cast<byte>(coreInstructionTicks[op] * 2) }
+#define CB_OPCODE(op)   { &Cpu::executeCbOpcode<op>, &Cpu::callCbOpcode<op>, static_cast<byte>(cbInstructionTicks[op] / 4), static_cast<byte>(cbInstructionTicks[op]) }
+
+#define OPCODE_ROW(entry, hi) \
+	entry(hi + 0x0), entry(hi + 0x1), entry(hi + 0x2), entry(hi + 0x3), \
+	entry(hi + 0x4), entry(hi + 0x5), entry(hi + 0x6), entry(hi + 0x7), \
+	entry(hi + 0x8), entry(hi + 0x9), entry(hi + 0xA), entry(hi + 0xB), \
+	entry(hi + 0xC), entry(hi + 0xD), entry(hi + 0xE), entry(hi + 0xF)
+
+const Cpu::opcode_entry Cpu::s_coreOpcodes[256] = {
+	OPCODE_ROW(CORE_OPCODE, 0x00),
+	OPCODE_ROW(CORE_OPCODE, 0x10),
+	OPCODE_ROW(CORE_OPCODE, 0x20),
+	OPCODE_ROW(CORE_OPCODE, 0x30),
+	OPCODE_ROW(CORE_OPCODE, 0x40),
+	OPCODE_ROW(CORE_OPCODE, 0x50),
+	OPCODE_ROW(CORE_OPCODE, 0x60),
+	OPCODE_ROW(CORE_OPCODE, 0x70),
+	OPCODE_ROW(CORE_OPCODE, 0x80),
+	OPCODE_ROW(CORE_OPCODE, 0x90),
+	OPCODE_ROW(CORE_OPCODE, 0xA0),
+	OPCODE_ROW(CORE_OPCODE, 0xB0),
+	OPCODE_ROW(CORE_OPCODE, 0xC0),
+	OPCODE_ROW(CORE_OPCODE, 0xD0),
+	OPCODE_ROW(CORE_OPCODE, 0xE0),
+	OPCODE_ROW(CORE_OPCODE, 0xF0)
+};
 
-					_registers.B &= ~0x80;
+const Cpu::opcode_entry Cpu::s_cbOpcodes[256] = {
+	OPCODE_ROW(CB_OPCODE, 0x00),
+	OPCODE_ROW(CB_OPCODE, 0x10),
+	OPCODE_ROW(CB_OPCODE, 0x20),
+	OPCODE_ROW(CB_OPCODE, 0x30),
+	OPCODE_ROW(CB_OPCODE, 0x40),
+	OPCODE_ROW(CB_OPCODE, 0x50),
+	OPCODE_ROW(CB_OPCODE, 0x60),
+	OPCODE_ROW(CB_OPCODE, 0x70),
+	OPCODE_ROW(CB_OPCODE, 0x80),
+	OPCODE_ROW(CB_OPCODE, 0x90),
+	OPCODE_ROW(CB_OPCODE, 0xA0),
+	OPCODE_ROW(CB_OPCODE, 0xB0),
+	OPCODE_ROW(CB_OPCODE, 0xC0),
+	OPCODE_ROW(CB_OPCODE, 0xD0),
+	OPCODE_ROW(CB_OPCODE, 0xE0),
+	OPCODE_ROW(CB_OPCODE, 0xF0)
+};
 
-					if (prevBit)
-						setFlag(FLAG_C);
-					else
-						resetFlag(FLAG_C);
+#undef OPCODE_ROW
+#undef CB_OPCODE
+#undef CORE_OPCODE
 
-					if (_registers.B == 0x00)
-						setFlag(FLAG_Z);
-					else
-						resetFlag(FLAG_Z);
+timer_t Cpu::emulateCycle()
+{
+	if (_halted)
+	{
+		// Any enabled interrupt ends the HALT. With IME set handleInterrupts services it right after
+		// this step, without it execution simply resumes past the HALT
+		if (_registers.ime || *_raisedInterrupts == 0)
+		{
+			// Time keeps passing while halted so the display and timer can raise the wake-up interrupt
+			_registers.M = 1;
+			_registers.T = 4;
 
-					resetFlag(FLAG_N);
-					resetFlag(FLAG_H);
+			_internalM += _registers.M;
+			_internalT += _registers.T;
+			return _registers.T;
+		}
 
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x39: // SRL C
-				{
-					byte prevBit = _registers.C & 0x01;
+		_halted = false;
+	}
+	
+	const decoded_op& op = fetchOp();
+	_opcode        = op.opcode;
+	_isBitOpcode   = op.isBitOpcode;
+	_immediate     = op.immediate;
+	_registers.pc += op.isBitOpcode ? 2 : 1;
 
-					_registers.C >>= 1;
+	_registers.M = op.m;
+	_registers.T = op.t;
+	(this->*op.handler)();
 
-					_registers.C &= ~0x80;
+	_internalM += _registers.M;
+	_internalT += _registers.T;
+	return _registers.T;
+}
 
-					if (prevBit)
-						setFlag(FLAG_C);
-					else
-						resetFlag(FLAG_C);
+const Cpu::decoded_op Cpu::s_blockEnd = { nullptr, BLOCK_END, 0, 0, 0, 0, false };
 
-					if (_registers.C == 0x00)
-						setFlag(FLAG_Z);
-					else
-						resetFlag(FLAG_Z);
+const Cpu::decoded_op& Cpu::fetchOp()
+{
+	// Carry on through the current block for as long as execution follows it
+	const decoded_op* op = _nextOp;
+	if (op->address != _registers.pc)
+		op = findBlock(_registers.pc).ops;
 
-					resetFlag(FLAG_N);
-					resetFlag(FLAG_H);
+	_nextOp = op + 1;
+	return *op;
+}
 
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x3A: // SRL D
-				{
-					byte prevBit = _registers.D & 0x01;
+Cpu::decoded_block& Cpu::findBlock(const word pc)
+{
+	const code_version_t version = _memory.getCodeVersion(pc);
+	if (version == 0)
+	{
+		// Code the memory can't vouch for, one instruction at a time straight from the bus
+		decodeBlock(_uncachedBlock, pc, version);
+		return _uncachedBlock;
+	}
 
-					_registers.D >>= 1;
+	decoded_block& block = _blocks[pc & (BLOCK_CACHE_SIZE - 1)];
+	if (block.start != pc || block.version != version)
+	{
+		decodeBlock(block, pc, version);
+		_memory.watchCode(pc);
+	}
 
-					_registers.D &= ~0x80;
+	return block;
+}
 
-					if (prevBit)
-						setFlag(FLAG_C);
-					else
-						resetFlag(FLAG_C);
+void Cpu::decodeBlock(decoded_block& block, const word pc, const code_version_t version)
+{
+	block.start       = pc;
+	block.version     = version;
+	block.translation = nullptr;
+	block.executions  = 0;
+
+	byte count   = 0;
+	word address = pc;
+	do
+	{
+		decoded_op& op = block.ops[count];
+		op.address = address;
+		op.opcode  = _memory.readByte(address);
 
-					if (_registers.D == 0x00)
-						setFlag(FLAG_Z);
-					else
-						resetFlag(FLAG_Z);
+		const byte length = coreInstructionLengths[op.opcode];
+		const word last   = address + length - 1;
 
-					resetFlag(FLAG_N);
-					resetFlag(FLAG_H);
+		// An instruction running into different code is decoded on its own and never cached
+		if (version != 0 && _memory.getCodeVersion(last) != version)
+		{
+			if (count != 0)
+				break;
 
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x3B: // SRL E
-				{
-					byte prevBit = _registers.E & 0x01;
+			block.version = 0;
+		}
 
-					_registers.E >>= 1;
+		if (op.opcode == 0xCB)
+		{
+			op.opcode      = _memory.readByte(last);
+			op.isBitOpcode = true;
+			op.immediate   = 0;
 
-					_registers.E &= ~0x80;
+			const opcode_entry& entry = s_cbOpcodes[op.opcode];
+			op.handler = entry.handler;
+			op.m       = entry.m;
+			op.t       = entry.t;
+		}
+		else
+		{
+			op.isBitOpcode = false;
+			op.immediate   = length == 3 ? _memory.readWord(address + 1) : length == 2 ? _memory.readByte(last) : 0;
 
-					if (prevBit)
-						setFlag(FLAG_C);
-					else
-						resetFlag(FLAG_C);
+			const opcode_entry& entry = s_coreOpcodes[op.opcode];
+			op.handler = entry.handler;
+			op.m       = entry.m;
+			op.t       = entry.t;
+		}
 
-					if (_registers.E == 0x00)
-						setFlag(FLAG_Z);
-					else
-						resetFlag(FLAG_Z);
+		++count;
+		address += length;
 
-					resetFlag(FLAG_N);
-					resetFlag(FLAG_H);
+		if (!op.isBitOpcode && endsBlock(op.opcode))
+			break;
+	}
+	while (block.version != 0 && count < MAX_BLOCK_LENGTH && _memory.getCodeVersion(address) == version);
 
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x3C: // SRL H
-				{
-					byte prevBit = _registers.H & 0x01;
+	block.ops[count] = s_blockEnd;
+}
 
-					_registers.H >>= 1;
+void Cpu::flushBlocks()
+{
+	for (decoded_block& block: _blocks)
+		block.version = 0;
 
-					_registers.H &= ~0x80;
+	_nextOp = &s_blockEnd;
+}
 
-					if (prevBit)
-						setFlag(FLAG_C);
-					else
-						resetFlag(FLAG_C);
+// Index of the lowest set bit, val must not be 0
+static inline byte lowestSetBit(const byte val)
+{
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward(&index, val);
+	return static_cast<byte>(index);
+#else
+	return static_cast<byte>(__builtin_ctz(val));
+#endif
+}
 
-					if (_registers.H == 0x00)
-						setFlag(FLAG_Z);
-					else
-						resetFlag(FLAG_Z);
+timer_t Cpu::handleInterrupts()
+{
+	const byte pending = *_raisedInterrupts & _interruptMask;
+	if (pending == 0)
+		return 0;
 
-					resetFlag(FLAG_N);
-					resetFlag(FLAG_H);
+	// IF bit order is also priority order
+	const byte interrupt = lowestSetBit(pending);
+	_memory.resetInterrupt(1 << interrupt);
 
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x3D: // SRL L
-				{
-					byte prevBit = _registers.L & 0x01;
+	switch (interrupt)
+	{
+		case 0:  RST40(); break;
+		case 1:  RST48(); break;
+		case 2:  RST50(); break;
+		case 3:  RST58(); break;
+		default: RST60(); break;
+	}
 
-					_registers.L >>= 1;
+	_halted = false;
 
-					_registers.L &= ~0x80;
+	// The handler runs in between, so the last trip round a loop is no guide to the next one
+	resetPollingLoop();
+	return _registers.T;
+}
 
-					if (prevBit)
-						setFlag(FLAG_C);
-					else
-						resetFlag(FLAG_C);
+// IE & IF is kept up to date by the memory, IME is folded into a mask when it changes so checking for
+// an interrupt to service after every instruction is a single test
+void Cpu::setIME(const byte ime)
+{
+	_registers.ime = ime;
+	_interruptMask = ime ? Memory::INTERRUPT_FLAGS_ALL : 0;
+}
 
-					if (_registers.L == 0x00)
-						setFlag(FLAG_Z);
-					else
-						resetFlag(FLAG_Z);
+bool Cpu::isIdle() const
+{
+	return _halted && *_raisedInterrupts == 0;
+}
 
-					resetFlag(FLAG_N);
-					resetFlag(FLAG_H);
+void Cpu::idle(const cycle_t cycles)
+{
+	_internalM += static_cast<timer_t>(cycles / 4);
+	_internalT += static_cast<timer_t>(cycles);
+}
 
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x3E: // SRL (HL)
-				{
-					byte val = _memory.readByte((_registers.H << 8) + _registers.L);
+cycle_t Cpu::getPollingLoopPeriod() const
+{
+	return _pollingLoop.period;
+}
 
-					byte prevBit = val & 0x01;
+void Cpu::resetPollingLoop()
+{
+	_pollingLoop.armed  = false;
+	_pollingLoop.period = 0;
+}
 
-					val >>= 1;
-					val &= ~0x80;
+void Cpu::checkPollingLoop(const word branchAddress)
+{
+	polling_loop& loop = _pollingLoop;
 
-					if (prevBit)
-						setFlag(FLAG_C);
-					else
-						resetFlag(FLAG_C);
+	// Back at the same place with the same registers after a trip round a loop that reads only
+	// values which hold until the next event, so every trip until then is going to be the same
+	if (loop.armed && loop.start == _registers.pc && loop.branch == branchAddress && loop.A == _registers.A && loop.F == _registers.F)
+	{
+		if (loop.rejected != loop.start && isPollingLoop(loop.start, branchAddress))
+			loop.period = _internalT - loop.T;
+		else
+			loop.rejected = loop.start;
+	}
 
-					if (val == 0x00)
-						setFlag(FLAG_Z);
-					else
-						resetFlag(FLAG_Z);
+	loop.start  = _registers.pc;
+	loop.branch = branchAddress;
+	loop.A      = _registers.A;
+	loop.F      = _registers.F;
+	loop.T      = _internalT;
+	loop.armed  = true;
+}
 
-					resetFlag(FLAG_N);
-					resetFlag(FLAG_H);
+bool Cpu::isPollingLoop(const word start, const word branchAddress) const
+{
+	// Bodies may only change A and F, so every other register and every address read through them stays put.
+	// Anything that writes memory, uses the stack, branches or touches interrupts makes it a real loop
+	if (branchAddress - start > MAX_POLLING_LOOP_LENGTH)
+		return false;
 
-					_memory.writeByte((_registers.H << 8) + _registers.L, val);
+	word addr = start;
 
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
+	while (addr < branchAddress)
+	{
+		const byte opcode = _memory.readByte(addr);
+		word readAddress  = 0;
+		bool reads        = false;
+		byte length       = 1;
+
+		switch (opcode)
+		{
+			case 0x00: case 0x07: case 0x0F: case 0x17: case 0x1F: // NOP, RLCA, RRCA, RLA, RRA
+			case 0x27: case 0x2F: case 0x37: case 0x3F:             // DAA, CPL, SCF, CCF
+			case 0x3C: case 0x3D:                                   // INC A, DEC A
+				break;
+
+			case 0x3E: length = 2; break;                                                                   // LD A, n
+			case 0x0A: reads = true; readAddress = (_registers.B << 8) + _registers.C; break;               // LD A, (BC)
+			case 0x1A: reads = true; readAddress = (_registers.D << 8) + _registers.E; break;               // LD A, (DE)
+			case 0xF2: reads = true; readAddress = 0xFF00 + _registers.C; break;                            // LD A, (C)
+			case 0xF0: reads = true; readAddress = 0xFF00 + _memory.readByte(addr + 1); length = 2; break; // LDH A, (n)
+			case 0xFA: reads = true; readAddress = _memory.readWord(addr + 1); length = 3; break;          // LD A, (nn)
+
+			case 0xCB:
+			{
+				// BIT on anything, shifts, RES and SET on A only
+				const byte cbOpcode = _memory.readByte(addr + 1);
+				length = 2;
 
-				// Swaps
-				case 0x37: // SWAP A
-				{
-					_registers.A = ((_registers.A & 0x0F) << 4 |
-						            (_registers.A & 0xF0) >> 4);
-
-					if (_registers.A == 0x00)
-						setFlag(FLAG_Z);
-					else
-						resetFlag(FLAG_Z);
-
-					resetFlag(FLAG_H);
-					resetFlag(FLAG_C);
-					resetFlag(FLAG_N);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x30: // SWAP B
+				if (cbOpcode >= 0x40 && cbOpcode <= 0x7F)
 				{
-					_registers.B = ((_registers.B & 0x0F) << 4 |
-						            (_registers.B & 0xF0) >> 4);
-
-					if (_registers.B == 0x00)
-						setFlag(FLAG_Z);
-					else
-						resetFlag(FLAG_Z);
-
-					resetFlag(FLAG_H);
-					resetFlag(FLAG_C);
-					resetFlag(FLAG_N);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x31: // SWAP C
+					reads       = (cbOpcode & 7) == 6;
+					readAddress = (_registers.H << 8) + _registers.L;
+				}
+				else if ((cbOpcode & 7) != 7)
 				{
-					_registers.C = ((_registers.C & 0x0F) << 4 |
-						            (_registers.C & 0xF0) >> 4);
-
-					if (_registers.C == 0x00)
-						setFlag(FLAG_Z);
-					else
-						resetFlag(FLAG_Z);
-
-					resetFlag(FLAG_H);
-					resetFlag(FLAG_C);
-					resetFlag(FLAG_N);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x32: // SWAP D
-				{
-					_registers.D = ((_registers.D & 0x0F) << 4 |
-						            (_registers.D & 0xF0) >> 4);
-
-					if (_registers.D == 0x00)
-						setFlag(FLAG_Z);
-					else
-						resetFlag(FLAG_Z);
-
-					resetFlag(FLAG_H);
-					resetFlag(FLAG_C);
-					resetFlag(FLAG_N);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x33: // SWAP E
-				{
-					_registers.E = ((_registers.E & 0x0F) << 4 |
-						            (_registers.E & 0xF0) >> 4);
-
-					if (_registers.E == 0x00)
-						setFlag(FLAG_Z);
-					else
-						resetFlag(FLAG_Z);
-
-					resetFlag(FLAG_H);
-					resetFlag(FLAG_C);
-					resetFlag(FLAG_N);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x34: // SWAP H
-				{
-					_registers.H = ((_registers.H & 0x0F) << 4 |
-						            (_registers.H & 0xF0) >> 4);
-
-					if (_registers.H == 0x00)
-						setFlag(FLAG_Z);
-					else
-						resetFlag(FLAG_Z);
-
-					resetFlag(FLAG_H);
-					resetFlag(FLAG_C);
-					resetFlag(FLAG_N);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x35: // SWAP L
-				{
-					_registers.L = ((_registers.L & 0x0F) << 4 |
-						            (_registers.L & 0xF0) >> 4);
-
-					if (_registers.L == 0x00)
-						setFlag(FLAG_Z);
-					else
-						resetFlag(FLAG_Z);
-
-					resetFlag(FLAG_H);
-					resetFlag(FLAG_C);
-					resetFlag(FLAG_N);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
-				case 0x36: // SWAP (HL)
-				{
-					byte val = _memory.readByte((_registers.H << 8) + _registers.L);
-
-					val = ((val & 0x0F) << 4 |
-						   (val & 0xF0) >> 4);
-
-					if (val == 0x00)
-						setFlag(FLAG_Z);
-					else
-						resetFlag(FLAG_Z);
-
-					resetFlag(FLAG_H);
-					resetFlag(FLAG_C);
-					resetFlag(FLAG_N);
+					return false;
+				}
+			} break;
 
-					_memory.writeByte((_registers.H << 8) + _registers.L, val);
-
-					_registers.M = cbInstructionTicks[_opcode] / 4;
-					_registers.T = cbInstructionTicks[_opcode];
-				} break;
+			default:
+			{
+				// LD A, r and ALU A, r / A, n, which only read memory through (HL)
+				if ((opcode >= 0x78 && opcode <= 0xBF) || (opcode & 0xC7) == 0xC6)
+				{
+					const bool immediate = (opcode & 0xC7) == 0xC6;
 
-				default:
+					reads       = !immediate && (opcode & 7) == 6;
+					readAddress = (_registers.H << 8) + _registers.L;
+					length      = immediate ? 2 : 1;
+				}
+				else
 				{
-					std::cout << ">>> at: 0x" << std::hex << _registers.pc << " unimplemented cb instruction: 0x" << std::hex << static_cast<int>(_opcode) << " <<<" << std::endl;
-					_errorState = ES_UNIMPLEMENTED_INSTRUCTION;
-				} 
+					return false;
+				}
 			}
-		} break;
-
-		default:
-		{
-			std::cout << ">>> at: 0x" << std::hex << _registers.pc << " unimplemented instruction: 0x" << std::hex << static_cast<int>(_opcode) << " <<<" << std::endl;
-			_errorState = ES_UNIMPLEMENTED_INSTRUCTION;
 		}
-	}
-
-	_internalM += _registers.M;
-	_internalT += _registers.T;	
-	incrementTimer();
-}
 
-void Cpu::handleInterrupts()
-{
-	if (getIME() && _memory.getIE() && _memory.getIF())
-	{
-		byte maskedInterrupts = _memory.getIE() & _memory.getIF();
+		// DIV and TIMA count up between events, so a loop reading the timer really is waiting on time
+		if (reads && readAddress >= 0xFF04 && readAddress <= 0xFF07)
+			return false;
 
-		if ((maskedInterrupts & Memory::INTERRUPT_FLAG_VBLANK) != 0)
-		{
-			_memory.resetInterrupt(Memory::INTERRUPT_FLAG_VBLANK);
-			RST40();
-			_halted = false;
-			incrementTimer();
-		}
-		else if ((maskedInterrupts & Memory::INTERRUPT_FLAG_TOGGLELCD) != 0)
-		{
-			_memory.resetInterrupt(Memory::INTERRUPT_FLAG_TOGGLELCD);
-			RST48();
-			_halted = false;
-			incrementTimer();
-		}
-		else if ((maskedInterrupts & Memory::INTERRUPT_FLAG_TIMER) != 0)
-		{
-			_memory.resetInterrupt(Memory::INTERRUPT_FLAG_TIMER);
-			RST50();
-			_halted = false;
-			incrementTimer();
-		}
-		else if ((maskedInterrupts & Memory::INTERRUPT_FLAG_SERIAL) != 0)
-		{
-			_memory.resetInterrupt(Memory::INTERRUPT_FLAG_SERIAL);
-			RST58();
-			_halted = false;
-			incrementTimer();
-		}
-		else if ((maskedInterrupts & Memory::INTERRUPT_FLAG_JOYPAD) != 0)
-		{
-			_memory.resetInterrupt(Memory::INTERRUPT_FLAG_JOYPAD);
-			RST60();
-			_halted = false;
-			incrementTimer();
-		}
+		addr += length;
 	}
+
+	return addr == branchAddress;
 }
 
 void Cpu::RST40()
 {
-	_registers.ime = 0;
+	setIME(0);
 	_registers.sp -= 2;
 	_memory.writeWord(_registers.sp, _registers.pc);
 
@@ -7018,7 +2103,7 @@ void Cpu::RST40()
 
 void Cpu::RST48()
 {
-	_registers.ime = 0;
+	setIME(0);
 	_registers.sp -= 2;
 	_memory.writeWord(_registers.sp, _registers.pc);
 
@@ -7032,7 +2117,7 @@ void Cpu::RST48()
 
 void Cpu::RST50()
 {
-	_registers.ime = 0;
+	setIME(0);
 	_registers.sp -= 2;
 	_memory.writeWord(_registers.sp, _registers.pc);
 
@@ -7046,7 +2131,7 @@ void Cpu::RST50()
 
 void Cpu::RST58()
 {
-	_registers.ime = 0;
+	setIME(0);
 	_registers.sp -= 2;
 	_memory.writeWord(_registers.sp, _registers.pc);
 
@@ -7060,7 +2145,7 @@ void Cpu::RST58()
 
 void Cpu::RST60()
 {
-	_registers.ime = 0;
+	setIME(0);
 	_registers.sp -= 2;
 	_memory.writeWord(_registers.sp, _registers.pc);
 
@@ -7075,18 +2160,81 @@ void Cpu::RST60()
 void Cpu::resetCpu()
 {
 	_registers = {};
-	_registers.ime = 1;
+	setIME(1);
 	_internalM = 0;
 	_internalT = 0;
-	_clockSub = 0;
-	_clockDiv = 0;
-	_clockMain = 0;
 
 	_registers.pc = 0x0000;
 
 	_opcode      = NO_OPCODE;
 	_isBitOpcode = false;
 	_halted      = false;
+
+	_pollingLoop          = {};
+	_pollingLoop.rejected = NO_POLLING_LOOP;
+
+	flushBlocks();
+}
+
+void Cpu::skipBios()
+{
+	// Register file as the bios leaves it when jumping to the cart entry point
+	_registers.A  = 0x01;
+	_registers.F  = 0xB0;
+	_registers.B  = 0x00;
+	_registers.C  = 0x13;
+	_registers.D  = 0x00;
+	_registers.E  = 0xD8;
+	_registers.H  = 0x01;
+	_registers.L  = 0x4D;
+	_registers.sp = 0xFFFE;
+	_registers.pc = 0x0100;
+}
+
+void Cpu::serialize(StateWriter& writer) const
+{
+	writer.writeByte(_registers.A);
+	writer.writeByte(_registers.B);
+	writer.writeByte(_registers.C);
+	writer.writeByte(_registers.D);
+	writer.writeByte(_registers.E);
+	writer.writeByte(_registers.H);
+	writer.writeByte(_registers.L);
+	writer.writeByte(_registers.F);
+	writer.writeWord(_registers.pc);
+	writer.writeWord(_registers.sp);
+	writer.writeDword(_registers.M);
+	writer.writeDword(_registers.T);
+	writer.writeByte(_registers.ime);
+	writer.writeByte(_halted ? 1 : 0);
+	writer.writeDword(_internalM);
+	writer.writeDword(_internalT);
+	writer.writeByte(_opcode);
+	writer.writeByte(_isBitOpcode);
+}
+
+void Cpu::deserialize(StateReader& reader)
+{
+	_registers.A   = reader.readByte();
+	_registers.B   = reader.readByte();
+	_registers.C   = reader.readByte();
+	_registers.D   = reader.readByte();
+	_registers.E   = reader.readByte();
+	_registers.H   = reader.readByte();
+	_registers.L   = reader.readByte();
+	_registers.F   = reader.readByte();
+	_registers.pc  = reader.readWord();
+	_registers.sp  = reader.readWord();
+	_registers.M   = reader.readDword();
+	_registers.T   = reader.readDword();
+	setIME(reader.readByte());
+	_halted        = reader.readByte() != 0;
+	_internalM     = reader.readDword();
+	_internalT     = reader.readDword();
+	_opcode        = reader.readByte();
+	_isBitOpcode   = reader.readByte();
+
+	resetPollingLoop();
 }
 
 void Cpu::printRegisters()
@@ -7124,50 +2272,4 @@ byte Cpu::getLastExecutedOpcode() const { return _opcode; }
 byte Cpu::getIME() const { return _registers.ime; }
 
 void Cpu::setFlag(const byte flag)   { _registers.F |= flag; }
-void Cpu::resetFlag(const byte flag) { _registers.F &= ~flag; }
-
-void Cpu::incrementTimer()
-{
-	_clockSub += (byte)_registers.M;
-
-	if (_clockSub > 3)
-	{
-		_clockMain++;
-		_clockSub -= 4;
-
-		if (++_clockDiv == 16)
-		{
-			_memory.incrementDiv();
-			_clockDiv = 0;
-		}
-	}
-
-	byte tac = _memory.readByte(0xFF07);
-	byte inputClockSel = tac & 0x3;
-
-	switch (inputClockSel)
-	{
-		case 0x00: if (_clockMain >= 64) stepTimer(); break; // 4K
-		case 0x01: if (_clockMain >= 1)  stepTimer(); break; // 256K
-		case 0x02: if (_clockMain >= 4)  stepTimer(); break; // 64K
-		case 0x03: if (_clockMain >= 16) stepTimer(); break; // 16K
-	}
-}
-
-void Cpu::stepTimer()
-{
-	_clockMain = 0;
-
-	byte tima = _memory.readByte(0xFF05);
-
-	if (tima == 0xFF)
-	{
-		byte tma = _memory.readByte(0xFF06);
-		_memory.writeByte(0xFF05, tma);
-		*(_memory.getIFPtr()) |= Memory::INTERRUPT_FLAG_TIMER;
-	}
-	else
-	{
-		_memory.writeByte(0xFF05, tima + 1);
-	}
-}
\ No newline at end of file
+void Cpu::resetFlag(const byte flag) { _registers.F &= ~flag; }
\ No newline at end of file
@@ -1,18 +1,38 @@
 #pragma once
 #include "common.h"
 
+#include <vector>
+
 class Memory;
+class StateReader;
+class StateWriter;
 class Cpu final
 {
+	// Runs translated blocks straight on the register file and the block cache
+	friend class Jit;
+
 public:
 	Cpu(Memory&);
 
-	void emulateCycle();
-	void handleInterrupts();
+	timer_t emulateCycle();
+	timer_t handleInterrupts();
 
 	void resetCpu();
+	void skipBios();
+
+	// Halted with no enabled interrupt pending, so nothing the cpu does can change state until one is raised
+	bool isIdle() const;
+	void idle(const cycle_t cycles);
+
+	// Length in cycles of a polling loop that just went round without changing anything, 0 if there is none.
+	// Until the next scheduled event it can only keep doing exactly the same
+	cycle_t getPollingLoopPeriod() const;
+	void resetPollingLoop();
 	void printRegisters();
 
+	void serialize(StateWriter& writer) const;
+	void deserialize(StateReader& reader);
+
 	const word* getPC() const;
 	const timer_t* getT() const;
 
@@ -38,8 +58,75 @@ private:
 
 	void resetFlag(const byte flag);
 	void setFlag(const byte flag);
-	void incrementTimer();
-	void stepTimer();
+
+	byte immediateByte();
+	void setIME(const byte ime);
+	void takeBranch(const word branchAddress, const word target);
+	void checkPollingLoop(const word branchAddress);
+	bool isPollingLoop(const word start, const word branchAddress) const;
+
+private:
+	using opcode_handler_t = void (Cpu::*)();
+
+	// Plain function versions of the handlers for generated code, which can't call through member pointers
+	using opcode_thunk_t = void (*)(Cpu*);
+
+	struct opcode_entry
+	{
+		opcode_handler_t handler;
+		opcode_thunk_t   thunk;
+		byte             m;
+		byte             t;
+	};
+
+	template<byte opcode> void executeCoreOpcode();
+	template<byte opcode> void executeCbOpcode();
+	template<byte opcode> static void callCoreOpcode(Cpu* cpu);
+	template<byte opcode> static void callCbOpcode(Cpu* cpu);
+	template<byte operand> byte readOperand();
+	template<byte operand> void writeOperand(const byte val);
+	template<byte operation> void executeAluOperation(const byte val);
+	template<byte operation> byte executeShiftOperation(const byte val);
+
+	static const opcode_entry s_coreOpcodes[256];
+	static const opcode_entry s_cbOpcodes[256];
+
+private:
+	static const byte MAX_BLOCK_LENGTH = 8;
+
+	// One instruction with its handler, cycle cost and immediate operand already looked up
+	struct decoded_op
+	{
+		opcode_handler_t handler;
+		dword            address;
+		word             immediate;
+		byte             opcode;
+		byte             m;
+		byte             t;
+		bool             isBitOpcode;
+	};
+
+	// Straight line run of instructions, good for as long as its page holds the same code version.
+	// The op after the last one is an end marker whose address pc can never reach
+	struct decoded_block
+	{
+		decoded_op     ops[MAX_BLOCK_LENGTH + 1];
+		code_version_t version;
+		word           start;
+
+		// Native code for the leading ops once the block has run often enough, see Jit
+		const byte*    translation;
+		dword          executions;
+		byte           translatedOps;
+		byte           translatedLeadCycles;
+	};
+
+	const decoded_op& fetchOp();
+	decoded_block& findBlock(const word pc);
+	void decodeBlock(decoded_block& block, const word pc, const code_version_t version);
+	void flushBlocks();
+
+	static const decoded_op s_blockEnd;
 
 private:
 	enum error_state
@@ -56,15 +143,31 @@ private:
 		byte ime;
 	};
 
+	// State at the last backward branch, a loop is found when the next one lands back here unchanged
+	struct polling_loop
+	{
+		word    start;
+		word    branch;
+		word    rejected;
+		byte    A, F;
+		timer_t T;
+		timer_t period;
+		bool    armed;
+	};
+
 private:
-	registers   _registers;
-	bool        _halted;
-	timer_t     _internalM, _internalT;
-	byte        _clockSub;
-	byte        _clockDiv;
-	byte        _clockMain;
-	byte        _opcode;
-	byte        _isBitOpcode;
-	error_state _errorState;
-	Memory&	    _memory;
+	registers                  _registers;
+	polling_loop               _pollingLoop;
+	std::vector<decoded_block> _blocks;
+	decoded_block              _uncachedBlock;
+	const decoded_op*          _nextOp;
+	bool                       _halted;
+	byte                       _interruptMask;
+	const byte*                _raisedInterrupts;
+	timer_t                    _internalM, _internalT;
+	word                       _immediate;
+	byte                       _opcode;
+	byte                       _isBitOpcode;
+	error_state                _errorState;
+	Memory&	                   _memory;
 };
\ No newline at end of file
@@ -2,12 +2,14 @@
 
 #include "cpu.h"
 #include "memory.h"
+#include "pixels.h"
+#include "profile.h"
+#include "scheduler.h"
+#include "state.h"
 #include "window.h"
 
 #include <memory.h>
 #include <iostream>
-#include <unordered_set>
-#include <unordered_map>
 
 #define PALETTE_SHIFT_ENABLED
 //#define SHOW_SELECTED_TILES
@@ -16,7 +18,6 @@ static const timer_t OAM_ACCESS_TIME  = 80;
 static const timer_t VRAM_ACCESS_TIME = 172;
 static const timer_t HBLANK_TIME      = 204;
 static const timer_t VBLANK_TIME      = 4560;
-static const timer_t FULL_FRAME_TIME  = 70224;
 
 static const byte DISPLAY_CONTROL_FLAG_BKG    = 0x01;
 static const byte DISPLAY_CONTROL_FLAG_SPR    = 0x02;
@@ -32,22 +33,26 @@ static const byte SPRITE_FLAG_X_FLIP  = 0x20;
 static const byte SPRITE_FLAG_Y_FLIP  = 0x40;
 static const byte SPRITE_FLAG_PRIO    = 0x80;
 
-static const dword COLOR_0 = 0x00D0F8E0;
-static const dword COLOR_1 = 0xFF70C088;
-static const dword COLOR_2 = 0xFF566834;
-static const dword COLOR_3 = 0xFF201808;
+// Register value that maps every color index onto the shade of the same number
+static const byte IDENTITY_PALETTE = 0xE4;
 
-static const std::unordered_map<dword, byte> s_colorToVal
+const Display::color_scheme Display::DEFAULT_COLOR_SCHEME
 {
-	{COLOR_0, 0},
-	{COLOR_1, 1},
-	{COLOR_2, 2},
-	{COLOR_3, 3}
+	{ 0x00D0F8E0, 0xFF70C088, 0xFF566834, 0xFF201808 }
 };
 
-Display::Display(fill_displays_callback_t fillDisplayCallback)
-	: _fillDisplayCallback(fillDisplayCallback)
+Display::Display(Scheduler& scheduler, fill_displays_callback_t fillDisplayCallback)
+	: _colorScheme(DEFAULT_COLOR_SCHEME)
+	, _scheduler(scheduler)
+	, _renderInterval(1)
+	, _frameRequested(false)
+	, _fillDisplayCallback(fillDisplayCallback)
 {
+	_scheduler.setHandler(Scheduler::EVENT_DISPLAY, [this](const cycle_t deadline)
+	{
+		advanceMode(deadline);
+	});
+
 	resetDisplay();
 }
 
@@ -61,18 +66,9 @@ byte Display::readByte(const word addr)
 		case 0xFF43: return _displayScrollX; break;
 		case 0xFF44: return _displayLine; break;
 		case 0xFF45: return _displayLYC; break;	
-		case 0xFF47: return s_colorToVal.at(_bkgPalette[0]) |
-			                s_colorToVal.at(_bkgPalette[1]) << 8 |
-							s_colorToVal.at(_bkgPalette[2]) << 16 |
-							s_colorToVal.at(_bkgPalette[3]) << 24; break;
-		case 0xFF48: return s_colorToVal.at(_spr0Palette[0]) |
-			                s_colorToVal.at(_spr0Palette[1]) << 8 |
-							s_colorToVal.at(_spr0Palette[2]) << 16 |
-							s_colorToVal.at(_spr0Palette[3]) << 24; break;
-		case 0xFF49: return s_colorToVal.at(_spr1Palette[0]) |
-			                s_colorToVal.at(_spr1Palette[1]) << 8 |
-							s_colorToVal.at(_spr1Palette[2]) << 16 |
-							s_colorToVal.at(_spr1Palette[3]) << 24; break;
+		case 0xFF47: return _bkgPaletteReg; break;
+		case 0xFF48: return _spr0PaletteReg; break;
+		case 0xFF49: return _spr1PaletteReg; break;
 		case 0xFF4A: return _displayWindowY; break;
 		case 0xFF4B: return _displayWindowX; break;
 
@@ -93,52 +89,31 @@ void Display::writeByte(const word addr, const byte val)
 		case 0xFF42: _displayScrollY = val; break;
 		case 0xFF43: _displayScrollX = val; break;
 		case 0xFF45: _displayLYC = val; break;
-		case 0xFF47: 
+		case 0xFF47:
 		{
+			_bkgPaletteReg = val;
 #ifdef PALETTE_SHIFT_ENABLED
-			for (size_t i = 0; i < 4; ++i)
-			{
-				switch ((val >> (i * 2)) & 3)
-				{
-					case 0: _bkgPalette[i] = COLOR_0; break;
-					case 1: _bkgPalette[i] = COLOR_1; break;
-					case 2: _bkgPalette[i] = COLOR_2; break;
-					case 3: _bkgPalette[i] = COLOR_3; break;
-				}
-			}
+			buildPalette(val, _bkgPalette);
 #endif
+			_tileViewStale = true;
 		} break;
 
 		case 0xFF48:
 		{
+			_spr0PaletteReg = val;
 #ifdef PALETTE_SHIFT_ENABLED
-			for (size_t i = 0; i < 4; ++i)
-			{
-				switch ((val >> (i * 2)) & 3)
-				{
-					case 0: _spr0Palette[i] = COLOR_0; break;
-					case 1: _spr0Palette[i] = COLOR_1; break;
-					case 2: _spr0Palette[i] = COLOR_2; break;
-					case 3: _spr0Palette[i] = COLOR_3; break;
-				}
-			}
+			buildPalette(val, _spr0Palette);
 #endif
+			_spriteViewStale = true;
 		} break;
 
 		case 0xFF49:
 		{
+			_spr1PaletteReg = val;
 #ifdef PALETTE_SHIFT_ENABLED
-			for (size_t i = 0; i < 4; ++i)
-			{
-				switch ((val >> (i * 2)) & 3)
-				{
-					case 0: _spr1Palette[i] = COLOR_0; break;
-					case 1: _spr1Palette[i] = COLOR_1; break;
-					case 2: _spr1Palette[i] = COLOR_2; break;
-					case 3: _spr1Palette[i] = COLOR_3; break;
-				}
-			}
+			buildPalette(val, _spr1Palette);
 #endif
+			_spriteViewStale = true;
 		} break;
 		case 0xFF4A: _displayWindowX = val; break;
 		case 0xFF4B: _displayWindowY = val; break;
@@ -161,25 +136,17 @@ void Display::resetDisplay()
 	// Clear Graphics
 	memset(_gfx, 0x77, sizeof(_gfx));
 	memset(_tileset, 0x00, sizeof(_tileset));
+	memset(_tileDirty, 0x00, sizeof(_tileDirty));
 	memset(_tileGfx, 0x00, sizeof(_tileGfx));
 	memset(_spriteGfx, 0x00, sizeof(_spriteGfx));
 
-	_bkgPalette[0] = COLOR_0;
-	_bkgPalette[1] = COLOR_1;
-	_bkgPalette[2] = COLOR_2;
-	_bkgPalette[3] = COLOR_3;
-
-	_spr0Palette[0] = COLOR_0;
-	_spr0Palette[1] = COLOR_1;
-	_spr0Palette[2] = COLOR_2;
-	_spr0Palette[3] = COLOR_3;
-
-	_spr1Palette[0] = COLOR_0;
-	_spr1Palette[1] = COLOR_1;
-	_spr1Palette[2] = COLOR_2;
-	_spr1Palette[3] = COLOR_3;
+	_bkgPaletteReg  = IDENTITY_PALETTE;
+	_spr0PaletteReg = IDENTITY_PALETTE;
+	_spr1PaletteReg = IDENTITY_PALETTE;
+	rebuildPalettes();
 	
-	_displayClock           = 0;
+	_displayMode            = DISPLAY_MODE_OAM_READ;
+	_frameCount             = 0;
 	_displayLine            = 0;
 	_displayControlRegister = 0;
 	_statRegister           = 0;
@@ -188,6 +155,9 @@ void Display::resetDisplay()
 	_displayLYC             = 0;
 	_displayWindowX         = 0;
 	_displayWindowY         = 0;
+	_renderingFrame         = shouldRenderFrame();
+	_tileViewStale          = true;
+	_spriteViewStale        = true;
 
 	for (byte i = 0; i < 40; ++i)
 	{
@@ -196,11 +166,76 @@ void Display::resetDisplay()
 		_spriteData[i].tile  = 0;
 		_spriteData[i].flags = 0;
 	}
+
+	_scheduler.schedule(Scheduler::EVENT_DISPLAY, _scheduler.getNow() + getModeDuration());
 }
 
-void Display::setZ80TimeRegister(const timer_t* T)
+void Display::serialize(StateWriter& writer, const bool includeFrame) const
 {
-	_z80Time = T;
+	writer.writeByte(static_cast<byte>(_displayMode));
+	writer.writeDword(_frameCount);
+	writer.writeByte(_displayLine);
+	writer.writeByte(_displayScrollX);
+	writer.writeByte(_displayScrollY);
+	writer.writeByte(_displayWindowX);
+	writer.writeByte(_displayWindowY);
+	writer.writeByte(_displayLYC);
+	writer.writeByte(_displayControlRegister);
+	writer.writeByte(_statRegister);
+
+	writer.writeByte(_bkgPaletteReg);
+	writer.writeByte(_spr0PaletteReg);
+	writer.writeByte(_spr1PaletteReg);
+
+	for (const sprite_data& sprite: _spriteData)
+	{
+		writer.writeDword(static_cast<dword>(sprite.x));
+		writer.writeDword(static_cast<dword>(sprite.y));
+		writer.writeByte(sprite.tile);
+		writer.writeByte(sprite.flags);
+	}
+
+	// The lines already drawn this frame, so a restore mid frame still presents a whole picture
+	writer.writeByte(includeFrame ? 1 : 0);
+	if (includeFrame)
+		writer.writeBlock(_gfx, sizeof(_gfx));
+}
+
+void Display::deserialize(StateReader& reader)
+{
+	_displayMode            = static_cast<display_mode>(reader.readByte() & 0x3);
+	_frameCount             = reader.readDword();
+	_displayLine            = reader.readByte();
+	_displayScrollX         = reader.readByte();
+	_displayScrollY         = reader.readByte();
+	_displayWindowX         = reader.readByte();
+	_displayWindowY         = reader.readByte();
+	_displayLYC             = reader.readByte();
+	_displayControlRegister = reader.readByte();
+	_statRegister           = reader.readByte();
+
+	// Only the registers are stored, so states restore under whatever color scheme is in use
+	_bkgPaletteReg  = reader.readByte();
+	_spr0PaletteReg = reader.readByte();
+	_spr1PaletteReg = reader.readByte();
+	rebuildPalettes();
+
+	for (sprite_data& sprite: _spriteData)
+	{
+		sprite.x     = static_cast<int>(reader.readDword());
+		sprite.y     = static_cast<int>(reader.readDword());
+		sprite.tile  = reader.readByte();
+		sprite.flags = reader.readByte();
+	}
+
+	// States without a picture leave whatever was last drawn in place
+	if (reader.readByte() != 0)
+		reader.readBlock(_gfx, sizeof(_gfx));
+
+	// Decoded tiles are derived from VRAM, which was just replaced underneath them
+	memset(_tileDirty, 0x01, sizeof(_tileDirty));
+	_tileViewStale   = true;
+	_spriteViewStale = true;
 }
 
 void Display::setMemory(Memory* const memory)
@@ -208,73 +243,146 @@ void Display::setMemory(Memory* const memory)
 	_memory = memory;
 }
 
-void Display::emulateGameboyDisplay()
+void Display::advanceMode(const cycle_t deadline)
 {
-	_displayClock += *_z80Time;
-
 	switch (_displayMode)
 	{
 		case DISPLAY_MODE_HBLANK:
 		{
-			if (_displayClock >= HBLANK_TIME)
+			++_displayLine;
+			
+			if (_displayLine == DISPLAY_ROWS)
 			{
-				_displayClock -= HBLANK_TIME;
-				++_displayLine;
-				
-				if (_displayLine == DISPLAY_ROWS)
-				{
-					_displayMode = DISPLAY_MODE_VBLANK;
-					fillTileViewGfx();
-					fillSpriteViewGfx();
-					_fillDisplayCallback(_gfx, _tileGfx, _spriteGfx);
-
-					if (_statRegister & 0x10)
-						*(_memory->getIFPtr()) |= Memory::INTERRUPT_FLAG_TOGGLELCD;
-						
-					*(_memory->getIFPtr()) |= Memory::INTERRUPT_FLAG_VBLANK;
-				}
-				else
-				{
-					_displayMode = DISPLAY_MODE_OAM_READ;
-				}
+				_displayMode = DISPLAY_MODE_VBLANK;
+				++_frameCount;
+				AGE_PROFILE_COUNT(frames);
+
+				if (_renderingFrame)
+					presentFrame();
+
+				if (_statRegister & 0x10)
+					_memory->requestInterrupt(Memory::INTERRUPT_FLAG_TOGGLELCD);
+					
+				_memory->requestInterrupt(Memory::INTERRUPT_FLAG_VBLANK);
+			}
+			else
+			{
+				_displayMode = DISPLAY_MODE_OAM_READ;
 			}
 		} break;
 
 		case DISPLAY_MODE_VBLANK:
 		{
-			if (_displayClock >= HBLANK_TIME + OAM_ACCESS_TIME + VRAM_ACCESS_TIME)
+			_displayLine++;
+			
+			if (_displayLine > 153)
 			{
-				_displayClock -= HBLANK_TIME + OAM_ACCESS_TIME + VRAM_ACCESS_TIME;
-				_displayLine++;
-				
-				if (_displayLine > 153)
-				{
-					_displayMode = DISPLAY_MODE_OAM_READ;
-					_displayLine = 0;
-				}
+				_displayMode    = DISPLAY_MODE_OAM_READ;
+				_displayLine    = 0;
+				_renderingFrame = shouldRenderFrame();
 			}
 		} break;
 
 		case DISPLAY_MODE_OAM_READ:
 		{
-			if (_displayClock >= OAM_ACCESS_TIME)
-			{
-				_displayClock -= OAM_ACCESS_TIME;
-				_displayMode = DISPLAY_MODE_VRAM_READ;
-			}
+			_displayMode = DISPLAY_MODE_VRAM_READ;
 		} break;
 
 		case DISPLAY_MODE_VRAM_READ:
 		{
-			if (_displayClock >= VRAM_ACCESS_TIME)
-			{
-				_displayClock -= VRAM_ACCESS_TIME;
-				_displayMode = DISPLAY_MODE_HBLANK;
+			_displayMode = DISPLAY_MODE_HBLANK;
 
+			// Skipped frames still run every mode and interrupt, they just never touch a pixel
+			if (_renderingFrame)
 				renderScanline();
-			}
 		} break;
-	} 
+	}
+
+	// Chain off the deadline rather than the current time so that mode lengths never drift
+	_scheduler.schedule(Scheduler::EVENT_DISPLAY, deadline + getModeDuration());
+}
+
+void Display::presentFrame()
+{
+	AGE_PROFILE_SCOPE(PS_FRAME_OUTPUT);
+
+	_fillDisplayCallback(_gfx);
+}
+
+void Display::setRenderInterval(const dword interval)
+{
+	_renderInterval = interval;
+}
+
+void Display::setColorScheme(const color_scheme& scheme)
+{
+	_colorScheme = scheme;
+	rebuildPalettes();
+
+	_tileViewStale   = true;
+	_spriteViewStale = true;
+}
+
+void Display::buildPalette(const byte reg, dword* const palette) const
+{
+	for (byte i = 0; i < 4; ++i)
+		palette[i] = _colorScheme.shades[(reg >> (i * 2)) & 3];
+}
+
+void Display::rebuildPalettes()
+{
+#ifdef PALETTE_SHIFT_ENABLED
+	buildPalette(_bkgPaletteReg,  _bkgPalette);
+	buildPalette(_spr0PaletteReg, _spr0Palette);
+	buildPalette(_spr1PaletteReg, _spr1Palette);
+#else
+	buildPalette(IDENTITY_PALETTE, _bkgPalette);
+	buildPalette(IDENTITY_PALETTE, _spr0Palette);
+	buildPalette(IDENTITY_PALETTE, _spr1Palette);
+#endif
+}
+
+void Display::requestFrame()
+{
+	// A frame that has not drawn its first line yet can still be drawn whole
+	if (_displayLine == 0 && _displayMode == DISPLAY_MODE_OAM_READ)
+		_renderingFrame = true;
+	else
+		_frameRequested = true;
+}
+
+const byte* Display::getTileView()
+{
+	// The selected tile highlight follows the tile map and LCDC, which are not tracked
+#ifndef SHOW_SELECTED_TILES
+	if (_tileViewStale)
+#endif
+		fillTileViewGfx();
+
+	_tileViewStale = false;
+	return _tileGfx;
+}
+
+const byte* Display::getSpriteView()
+{
+	if (_spriteViewStale)
+		fillSpriteViewGfx();
+
+	_spriteViewStale = false;
+	return _spriteGfx;
+}
+
+bool Display::shouldRenderFrame()
+{
+	// Decided once per frame as line 0 starts, so a frame is always drawn whole or not at all
+	const bool render = _frameRequested || (_renderInterval != RENDER_ON_REQUEST && _frameCount % _renderInterval == 0);
+	_frameRequested = false;
+	return render;
+}
+
+dword Display::getFrameCount() const
+{
+	return _frameCount;
 }
 
 void Display::changeSpriteData(const word addr, const byte val)
@@ -297,11 +405,15 @@ void Display::changeSpriteData(const word addr, const byte val)
 		// Flags
 		case 3: _spriteData[spriteIndex].flags = val; break;
 	}
+
+	_spriteViewStale = true;
 }
 
-void Display::changeTileData(const word tile, const word x, const word y, const byte color)
+void Display::invalidateTile(const word tile)
 {
-	_tileset[tile][y][x] = color;
+	_tileDirty[tile] = true;
+	_tileViewStale   = true;
+	_spriteViewStale = true;
 }
 
 void Display::printSpriteData(const int mouseX, const int mouseY)
@@ -314,7 +426,10 @@ void Display::printSpriteData(const int mouseX, const int mouseY)
 }
 
 void Display::renderScanline()
-{	
+{
+	AGE_PROFILE_SCOPE(PS_SCANLINE);
+	AGE_PROFILE_COUNT(scanlines);
+
 	word tileData = 0;
 	word backgroundMemory = 0;
 	bool unsign= true;
@@ -363,58 +478,17 @@ void Display::renderScanline()
 	else
 		yPos = _displayLine - windowY;
 
-	// Which of the 8 vertical pixels of the current tile is the scanline on?
-	word tileRow = (((byte)(yPos / 8)) * 32);
-
-	for (int pixel = 0; pixel < 160; pixel++)
+	if (!usingWindow)
 	{
-		byte xPos = pixel + scrollX;
-
-		if (usingWindow)
-			if (pixel >= windowX)
-				xPos = pixel - windowX;
-
-		// Which of the 32 horizontal tiles does this xPos fall within
-		word tileCol = xPos / 8;
-		signed short tileNum = 0;
-
-		word tileAddress = backgroundMemory + tileRow + tileCol;
-
-		if (unsign)
-			tileNum = (byte) _memory->readByte(tileAddress);
-		else
-			tileNum = (signed char) _memory->readByte(tileAddress);
-
-		word tileLocation = tileData;
-
-		if (unsign)
-			tileLocation += (tileNum * 16);
-		else
-			tileLocation += ((tileNum + 128) * 16);
-
-		byte line = yPos % 8;
-		line *= 2;
-		byte data1 = _memory->readByte(tileLocation + line);
-		byte data2 = _memory->readByte(tileLocation + line + 1);
-
-		int colorBit = xPos % 8;
-		colorBit -= 7;
-		colorBit *= -1;
-
-		int colorNum = 0;
-		if ((data2 & (1 << colorBit)) != 0x00)
-			colorNum += 2;
-		if ((data1 & (1 << colorBit)) != 0x00)
-			colorNum += 1;
-
-		dword emucol = _bkgPalette[colorNum];
-
-		int arrayIndex = (_displayLine * 160 * DISPLAY_DEPTH) + pixel * DISPLAY_DEPTH;
+		renderBackgroundSpan(0, DISPLAY_COLS, scrollX, yPos, backgroundMemory, tileData, unsign);
+	}
+	else
+	{
+		// Left of the window the line keeps scrolling, right of it the window starts at its own column 0
+		const int windowStart = windowX < DISPLAY_COLS ? windowX : DISPLAY_COLS;
 
-		_gfx[arrayIndex] = (emucol & 0x000000FF) >> 0;
-		_gfx[arrayIndex + 1] = (emucol & 0x0000FF00) >> 8;
-		_gfx[arrayIndex + 2] = (emucol & 0x00FF0000) >> 16;
-		_gfx[arrayIndex + 3] = (emucol & 0xFF000000) >> 24;
+		renderBackgroundSpan(0, windowStart, scrollX, yPos, backgroundMemory, tileData, unsign);
+		renderBackgroundSpan(windowStart, DISPLAY_COLS, 0, yPos, backgroundMemory, tileData, unsign);
 	}
 
 	/* ------------------ */
@@ -434,12 +508,12 @@ void Display::renderScanline()
 				spritePalette = _bkgPalette;
 				int displayOffset = (_displayLine * 160 + sx) * 4;
 
-				byte* tileRow;
+				const byte* tileRow;
 
 				if (isSpriteFlagSet(i, SPRITE_FLAG_Y_FLIP))
-					tileRow = _tileset[sd.tile][7 - (_displayLine - sy)];
+					tileRow = getTileRow(sd.tile, 7 - (_displayLine - sy));
 				else
-					tileRow = _tileset[sd.tile][_displayLine - sy];
+					tileRow = getTileRow(sd.tile, _displayLine - sy);
 
 				for (size_t x = 0; x < 8; ++x)
 				{
@@ -454,7 +528,7 @@ void Display::renderScanline()
 							emucol = spritePalette[tileRow[7 - x]];
 
 						// If transparent pixel ignore
-						if (emucol == COLOR_0)
+						if (emucol == _colorScheme.shades[0])
 						{
 							displayOffset += 4;
 							continue;
@@ -467,7 +541,7 @@ void Display::renderScanline()
 										    _gfx[displayOffset + 2] << 16 |
 											_gfx[displayOffset + 3] << 24;
 
-							if (prevCol != COLOR_0)
+							if (prevCol != _colorScheme.shades[0])
 							{
 								displayOffset += 4;
 								continue;
@@ -481,6 +555,10 @@ void Display::renderScanline()
 
 						displayOffset += 4;
 					}
+					else
+					{
+						displayOffset += 4;
+					}
 				}
 			}
 
@@ -494,12 +572,12 @@ void Display::renderScanline()
 				spritePalette = _bkgPalette;
 				int displayOffset = ((_displayLine + 8) * 160 + sx) * 4;
 
-				byte* tileRow;
+				const byte* tileRow;
 
 				if (isSpriteFlagSet(i, SPRITE_FLAG_Y_FLIP))
-					tileRow = _tileset[sd.tile + 1][7 - (_displayLine - sy)];
+					tileRow = getTileRow(sd.tile + 1, 7 - (_displayLine - sy));
 				else
-					tileRow = _tileset[sd.tile + 1][_displayLine - sy];
+					tileRow = getTileRow(sd.tile + 1, _displayLine - sy);
 
 				for (size_t x = 0; x < 8; ++x)
 				{
@@ -513,7 +591,7 @@ void Display::renderScanline()
 						else
 							emucol = spritePalette[tileRow[7 - x]];						
 
-						if (emucol == COLOR_0)
+						if (emucol == _colorScheme.shades[0])
 						{
 							displayOffset += 4;
 							continue;
@@ -526,7 +604,7 @@ void Display::renderScanline()
 								_gfx[displayOffset + 2] << 16 |
 								_gfx[displayOffset + 3] << 24;
 
-							if (prevCol != COLOR_0)
+							if (prevCol != _colorScheme.shades[0])
 							{
 								displayOffset += 4;
 								continue;
@@ -540,54 +618,136 @@ void Display::renderScanline()
 
 						displayOffset += 4;
 					}
+					else
+					{
+						displayOffset += 4;
+					}
 				}
 			}
 		}
 	}
 }
 
-void Display::fillTileViewGfx()
+void Display::renderBackgroundSpan(const int firstPixel, const int endPixel, byte xPos, const byte yPos, const word tileMap, const word tileData, const bool unsign)
+{
+	// Which of the 32 tile rows and which of the 8 vertical pixels of the tile the scanline is on
+	const word tileRow = (yPos / 8) * 32;
+	const byte line    = yPos % 8;
+	const word baseTile = (tileData - 0x8000) / 16;
+
+	int arrayIndex = (_displayLine * DISPLAY_COLS + firstPixel) * DISPLAY_DEPTH;
+	int pixel      = firstPixel;
+
+	while (pixel < endPixel)
+	{
+		// Fetch each tile once, the first one of a span may start part way through when scrolled
+		const byte tileNum = _memory->retrieveFromVram(tileMap - 0x8000 + tileRow + xPos / 8);
+		const word tile    = unsign ? baseTile + tileNum : baseTile + 128 + static_cast<signed char>(tileNum);
+		const byte* colors = getTileRow(tile, line);
+
+		if (xPos % 8 == 0 && pixel + DISPLAY_TILE_COLS <= endPixel)
+		{
+			expandTileRow(colors, _bkgPalette, &_gfx[arrayIndex]);
+
+			pixel      += DISPLAY_TILE_COLS;
+			xPos       += DISPLAY_TILE_COLS;
+			arrayIndex += DISPLAY_TILE_COLS * DISPLAY_DEPTH;
+			continue;
+		}
+
+		for (byte col = xPos % 8; col < DISPLAY_TILE_COLS && pixel < endPixel; ++col, ++pixel, ++xPos)
+		{
+			const dword emucol = _bkgPalette[colors[col]];
+
+			_gfx[arrayIndex]     = (emucol & 0x000000FF) >> 0;
+			_gfx[arrayIndex + 1] = (emucol & 0x0000FF00) >> 8;
+			_gfx[arrayIndex + 2] = (emucol & 0x00FF0000) >> 16;
+			_gfx[arrayIndex + 3] = (emucol & 0xFF000000) >> 24;
+
+			arrayIndex += DISPLAY_DEPTH;
+		}
+	}
+}
+
+const byte* Display::getTileRow(const int tile, const int row)
 {
-	std::unordered_set<int> selectedTiles;
+	// Tall sprites reach their second tile through rows past 7, so rows are addressed as one flat range
+	int index = tile * DISPLAY_TILE_ROWS + row;
+	if (index < 0)
+		index += DISPLAY_TILES * DISPLAY_TILE_ROWS;
+	else if (index >= DISPLAY_TILES * DISPLAY_TILE_ROWS)
+		index -= DISPLAY_TILES * DISPLAY_TILE_ROWS;
+
+	const word tileIndex = index / DISPLAY_TILE_ROWS;
+	if (_tileDirty[tileIndex])
+		decodeTile(tileIndex);
+
+	return _tileset[tileIndex][index % DISPLAY_TILE_ROWS];
+}
+
+void Display::decodeTile(const word tile)
+{
+	const word baseAddress = tile * 16;
+
+	for (byte y = 0; y < DISPLAY_TILE_ROWS; ++y)
+	{
+		const byte lo = _memory->retrieveFromVram(baseAddress + y * 2);
+		const byte hi = _memory->retrieveFromVram(baseAddress + y * 2 + 1);
+
+		for (byte x = 0; x < DISPLAY_TILE_COLS; ++x)
+			_tileset[tile][y][x] = ((lo >> (7 - x)) & 1) | (((hi >> (7 - x)) & 1) << 1);
+	}
+
+	_tileDirty[tile] = false;
+}
 
+void Display::fillTileViewGfx()
+{
 #ifdef SHOW_SELECTED_TILES
+	bool selectedTiles[DISPLAY_TILES] = {};
+
 	if (isControlFlagSet(DISPLAY_CONTROL_FLAG_BKGTM))
 	{
 		for (int i = 0x9C00; i <= 0x9FFF; ++i)
 		{
-			selectedTiles.insert(_memory->retrieveFromVram(i - 0x8000));
+			selectedTiles[_memory->retrieveFromVram(i - 0x8000)] = true;
 		}
 	}
 	else
 	{
 		for (int i = 0x9800; i <= 0x9BFF; ++i)
 		{
-			selectedTiles.insert(_memory->retrieveFromVram(i - 0x8000));
+			selectedTiles[_memory->retrieveFromVram(i - 0x8000)] = true;
 		}
 	}
 #endif
 
 	for (int y = 0; y < DISPLAY_TILE_VIEW_BASE_HEIGHT; ++y)
 	{
-		for (int x = 0; x < DISPLAY_TILE_VIEW_BASE_WIDTH; ++x)
+		for (int x = 0; x < DISPLAY_TILE_VIEW_BASE_WIDTH; x += DISPLAY_TILE_COLS)
 		{
 			int tileIndex = (y / DISPLAY_TILE_ROWS) * DISPLAY_TILE_VIEW_TILES_PER_ROW + x / DISPLAY_TILE_COLS;
 
 			int arrayIndex = (y * DISPLAY_TILE_VIEW_BASE_WIDTH * DISPLAY_DEPTH) + x * DISPLAY_DEPTH;
-			byte color = (_tileset[tileIndex][y][x] & 0x03);
-			dword emucol = _bkgPalette[_tileset[tileIndex][y % DISPLAY_TILE_ROWS][x % DISPLAY_TILE_COLS]];
+			expandTileRow(getTileRow(tileIndex, y % DISPLAY_TILE_ROWS), _bkgPalette, &_tileGfx[arrayIndex]);
 	
 #ifdef SHOW_SELECTED_TILES
-			if (emucol == COLOR_0 && selectedTiles.count(tileIndex))
+			if (!selectedTiles[tileIndex])
+				continue;
+
+			for (int i = arrayIndex; i < arrayIndex + DISPLAY_TILE_COLS * DISPLAY_DEPTH; i += DISPLAY_DEPTH)
 			{
+				dword emucol = _tileGfx[i] | _tileGfx[i + 1] << 8 | _tileGfx[i + 2] << 16 | _tileGfx[i + 3] << 24;
+				if (emucol != _colorScheme.shades[0])
+					continue;
+
 				emucol = 0xFF00FF00;
+				_tileGfx[i]     = (emucol & 0x000000FF) >> 0;
+				_tileGfx[i + 1] = (emucol & 0x0000FF00) >> 8;
+				_tileGfx[i + 2] = (emucol & 0x00FF0000) >> 16;
+				_tileGfx[i + 3] = (emucol & 0xFF000000) >> 24;
 			}
 #endif
-
-			_tileGfx[arrayIndex]     = (emucol & 0x000000FF) >> 0;
-			_tileGfx[arrayIndex + 1] = (emucol & 0x0000FF00) >> 8;
-			_tileGfx[arrayIndex + 2] = (emucol & 0x00FF0000) >> 16;
-			_tileGfx[arrayIndex + 3] = (emucol & 0xFF000000) >> 24;
 		}
 	}
 }
@@ -603,16 +763,8 @@ void Display::fillSpriteViewGfx()
 
 		for (int y = 0; y < DISPLAY_TILE_ROWS; ++y)
 		{
-			for (int x = 0; x < DISPLAY_TILE_COLS; ++x)
-			{
-				dword* selPalette = isSpriteFlagSet(i, SPRITE_FLAG_PALETTE) ? _spr1Palette : _spr0Palette;
-				dword emucol = selPalette[_tileset[spriteData.tile][y][x] & 0x3];
-
-				_spriteGfx[(yOffset + y) * DISPLAY_SPRITE_AREA * DISPLAY_DEPTH + (xOffset + x) * DISPLAY_DEPTH]     = (emucol & 0x000000FF) >> 0;
-				_spriteGfx[(yOffset + y) * DISPLAY_SPRITE_AREA * DISPLAY_DEPTH + (xOffset + x) * DISPLAY_DEPTH + 1] = (emucol & 0x0000FF00) >> 8;
-				_spriteGfx[(yOffset + y) * DISPLAY_SPRITE_AREA * DISPLAY_DEPTH + (xOffset + x) * DISPLAY_DEPTH + 2] = (emucol & 0x00FF0000) >> 16;
-				_spriteGfx[(yOffset + y) * DISPLAY_SPRITE_AREA * DISPLAY_DEPTH + (xOffset + x) * DISPLAY_DEPTH + 3] = (emucol & 0xFF000000) >> 24;
-			}
+			const dword* selPalette = isSpriteFlagSet(i, SPRITE_FLAG_PALETTE) ? _spr1Palette : _spr0Palette;
+			expandTileRow(getTileRow(spriteData.tile, y), selPalette, &_spriteGfx[(yOffset + y) * DISPLAY_SPRITE_AREA * DISPLAY_DEPTH + xOffset * DISPLAY_DEPTH]);
 		}
 
 		xOffset += DISPLAY_TILE_COLS;
@@ -625,6 +777,18 @@ void Display::fillSpriteViewGfx()
 	}
 }
 
+timer_t Display::getModeDuration() const
+{
+	switch (_displayMode)
+	{
+		case DISPLAY_MODE_HBLANK:    return HBLANK_TIME;
+		case DISPLAY_MODE_VBLANK:    return HBLANK_TIME + OAM_ACCESS_TIME + VRAM_ACCESS_TIME;
+		case DISPLAY_MODE_OAM_READ:  return OAM_ACCESS_TIME;
+		case DISPLAY_MODE_VRAM_READ: return VRAM_ACCESS_TIME;
+	}
+	return OAM_ACCESS_TIME;
+}
+
 bool Display::isControlFlagSet(const byte flag) const
 {
 	return (_displayControlRegister & flag) != 0;
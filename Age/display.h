@@ -7,6 +7,9 @@
 
 class Window;
 class Memory;
+class Scheduler;
+class StateReader;
+class StateWriter;
 class Display final
 {
 public:
@@ -25,6 +28,12 @@ public:
 	static const word DISPLAY_SPRITE_VIEW_BASE_HEIGHT  = 40;
 	static const word DISPLAY_TILE_VIEW_TILES_PER_ROW = 16;
 
+	// Cycles from one vblank to the next, 154 lines of 456 cycles
+	static const timer_t FULL_FRAME_TIME = 70224;
+
+	// Render interval under which only frames asked for with requestFrame are drawn
+	static const dword RENDER_ON_REQUEST = 0;
+
 	struct sprite_data
 	{
 		int x, y;
@@ -32,29 +41,55 @@ public:
 		byte flags;
 	};
 
-	using fill_displays_callback_t  = std::function<void(byte*, byte*, byte*)>;
+	// The four RGBA shades the palette registers pick from, lightest first
+	struct color_scheme
+	{
+		dword shades[4];
+	};
+
+	static const color_scheme DEFAULT_COLOR_SCHEME;
+
+	using fill_displays_callback_t  = std::function<void(byte*)>;
 
 public:
-	Display(fill_displays_callback_t);
+	Display(Scheduler&, fill_displays_callback_t);
 
 	byte readByte(const word addr);
 	void writeByte(const word addr, const byte val);
 
 	void resetDisplay();
+
+	void serialize(StateWriter& writer, const bool includeFrame) const;
+	void deserialize(StateReader& reader);
 	
-	void setZ80TimeRegister(const timer_t* T);
 	void setMemory(Memory* const memory);
+	void presentFrame();
+	void setRenderInterval(const dword interval);
+	void setColorScheme(const color_scheme& scheme);
+	void requestFrame();
 
-	void emulateGameboyDisplay();
+	// Debug inspection, views are only redrawn when asked for and something they show has changed
+	const byte* getTileView();
+	const byte* getSpriteView();
+
+	dword getFrameCount() const;
 	void changeSpriteData(const word addr, const byte val);
-	void changeTileData(const word tile, const word x, const word y, const byte color);
+	void invalidateTile(const word tile);
 	void printSpriteData(const int mouseX, const int mouseY);
 
 private:
 
+	void advanceMode(const cycle_t deadline);
+	bool shouldRenderFrame();
+	void buildPalette(const byte reg, dword* const palette) const;
+	void rebuildPalettes();
 	void renderScanline();
+	void renderBackgroundSpan(const int firstPixel, const int endPixel, byte xPos, const byte yPos, const word tileMap, const word tileData, const bool unsign);
+	const byte* getTileRow(const int tile, const int row);
+	void decodeTile(const word tile);
 	void fillTileViewGfx();
 	void fillSpriteViewGfx();
+	timer_t getModeDuration() const;
 	bool isControlFlagSet(const byte flag) const;
 	void setControlFlag(const byte flag);
 	bool isSpriteFlagSet(const byte spriteIndex, const byte flag) const;
@@ -72,20 +107,32 @@ private:
 private:
 	byte _gfx[DISPLAY_COLS * DISPLAY_ROWS * DISPLAY_DEPTH];
 	byte _tileset[DISPLAY_TILES][DISPLAY_TILE_ROWS][DISPLAY_TILE_COLS];
+	bool _tileDirty[DISPLAY_TILES];
 	byte _tileGfx[DISPLAY_TILE_VIEW_BASE_WIDTH * DISPLAY_TILE_VIEW_BASE_HEIGHT* DISPLAY_DEPTH];
 	byte _spriteGfx[DISPLAY_SPRITE_VIEW_BASE_WIDTH * DISPLAY_SPRITE_VIEW_BASE_HEIGHT * DISPLAY_DEPTH];
 
 	sprite_data _spriteData[DISPLAY_SPRITES];
 	
+	// Raw BGP/OBP0/OBP1 register values, each expanded into a lookup table of the current scheme's shades
+	byte  _bkgPaletteReg;
+	byte  _spr0PaletteReg;
+	byte  _spr1PaletteReg;
 	dword _bkgPalette[4];
 	dword _spr0Palette[4];
 	dword _spr1Palette[4];
 
-	const timer_t* _z80Time;
+	color_scheme _colorScheme;
+
 	Memory* _memory;
+	Scheduler& _scheduler;
 
 	display_mode   _displayMode;
-	timer_t        _displayClock;
+	dword          _frameCount;
+	dword          _renderInterval;
+	bool           _frameRequested;
+	bool           _renderingFrame;
+	bool           _tileViewStale;
+	bool           _spriteViewStale;
 	byte           _displayLine;
 	byte           _displayScrollX;
 	byte           _displayScrollY;
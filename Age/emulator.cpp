@@ -0,0 +1,251 @@
+#include "emulator.h"
+#include "profile.h"
+#include "state.h"
+
+#include <algorithm>
+#include <fstream>
+
+Emulator::Emulator(Display::fill_displays_callback_t fillDisplayCallback)
+	: _timer(_scheduler)
+	, _display(_scheduler, fillDisplayCallback)
+	, _memory(_display, _input, _timer)
+	, _cpu(_memory)
+	, _jit(_cpu, _scheduler)
+	, _breakpoint(NO_BREAKPOINT)
+	, _tracing(false)
+	, _skipBios(false)
+	, _romLoaded(false)
+{
+	connectSystems();
+}
+
+bool Emulator::loadRom(const std::string& romPath)
+{
+	std::ifstream file;
+	file.open(romPath, std::ios::binary|std::ios::ate);
+	if (!file.is_open())
+		return false;
+
+	std::ifstream::pos_type pos = file.tellg();
+	std::vector<char> programData(static_cast<int>(pos));
+
+	file.seekg(0, std::ios::beg);
+	file.read(&programData[0], pos);
+
+	loadRom(programData);
+	return true;
+}
+
+void Emulator::loadRom(const std::vector<char>& romData)
+{
+	reset();
+	_memory.fillRom(romData);
+
+	if (_skipBios)
+	{
+		_memory.skipBios();
+		_cpu.skipBios();
+	}
+
+	_romLoaded = true;
+}
+
+void Emulator::reset()
+{
+	_scheduler.resetScheduler();
+	_memory.resetMemory();
+	_cpu.resetCpu();
+	_input.resetInput();
+	_timer.resetTimer();
+	_display.resetDisplay();
+	connectSystems();
+
+	_tracing   = false;
+	_romLoaded = false;
+}
+
+void Emulator::saveState(std::vector<byte>& state, const bool includeFrame) const
+{
+	state.clear();
+
+	StateWriter writer(state);
+	writer.writeDword(STATE_MAGIC);
+	writer.writeDword(STATE_VERSION);
+
+	const std::string& cartName = _memory.getCartName();
+	writer.writeWord(static_cast<word>(cartName.size()));
+	writer.writeBlock(cartName.data(), cartName.size());
+	writer.writeDword(_memory.getCartChecksum());
+
+	_scheduler.serialize(writer);
+	_input.serialize(writer);
+	_timer.serialize(writer);
+	_display.serialize(writer, includeFrame);
+	_memory.serialize(writer);
+	_cpu.serialize(writer);
+}
+
+bool Emulator::loadState(const std::vector<byte>& state)
+{
+	if (!_romLoaded)
+		return false;
+
+	// A state that turns out to be truncated is only noticed halfway through applying it,
+	// so keep the current machine around to fall back to
+	std::vector<byte> previousState;
+	saveState(previousState);
+
+	if (applyState(state))
+		return true;
+
+	applyState(previousState);
+	return false;
+}
+
+cycle_t Emulator::runFor(const cycle_t cycles)
+{
+	const cycle_t start  = _scheduler.getNow();
+	const cycle_t target = start + cycles;
+
+	while (_scheduler.getNow() < target)
+		runSlice(target);
+
+	return _scheduler.getNow() - start;
+}
+
+cycle_t Emulator::runFrame()
+{
+	const cycle_t start = _scheduler.getNow();
+	const dword frame   = _display.getFrameCount();
+
+	while (_display.getFrameCount() == frame)
+		runSlice(Scheduler::NO_DEADLINE);
+
+	return _scheduler.getNow() - start;
+}
+
+void Emulator::setBreakpoint(const word address)
+{
+	_breakpoint = address;
+}
+
+void Emulator::setSkipBios(const bool skipBios)
+{
+	_skipBios = skipBios;
+}
+
+bool Emulator::setJitEnabled(const bool enabled)
+{
+	return _jit.setEnabled(enabled);
+}
+
+bool Emulator::isRomLoaded() const { return _romLoaded; }
+
+Scheduler& Emulator::getScheduler() { return _scheduler; }
+Input& Emulator::getInput() { return _input; }
+Timer& Emulator::getTimer() { return _timer; }
+Display& Emulator::getDisplay() { return _display; }
+Memory& Emulator::getMemory() { return _memory; }
+Cpu& Emulator::getCpu() { return _cpu; }
+
+void Emulator::runSlice(const cycle_t target)
+{
+	// Events fire and input arrives between slices, so loops seen before now say nothing about this one
+	_cpu.resetPollingLoop();
+
+	// Nothing outside the cpu changes state before the next scheduled event, so instructions
+	// run back to back until the clock crosses it. The deadline is re-read every instruction
+	// because register writes (TAC, TIMA, ...) can pull it in
+	while (_scheduler.getNow() < _scheduler.getNextDeadline() && _scheduler.getNow() < target)
+	{
+		if (_cpu.isIdle())
+		{
+			// Only a scheduled event can raise the interrupt that ends a HALT, so skip straight to it.
+			// Rounded up to whole machine cycles, which lands where stepping through the HALT would
+			const cycle_t cycles = (std::min(_scheduler.getNextDeadline(), target) - _scheduler.getNow() + 3) & ~3ULL;
+			_cpu.idle(cycles);
+			_scheduler.advance(cycles);
+			AGE_PROFILE_COUNT(haltSkips);
+			continue;
+		}
+
+		// Translated blocks keep the clock running themselves as they go
+		const dword translated = _jit.isEnabled() && !_tracing ? _jit.run(std::min(_scheduler.getNextDeadline(), target)) : 0;
+		if (translated != 0)
+		{
+			AGE_PROFILE_ADD(instructions, translated);
+			AGE_PROFILE_ADD(translatedInstructions, translated);
+		}
+		else
+		{
+			_scheduler.advance(_cpu.emulateCycle());
+			AGE_PROFILE_COUNT(instructions);
+		}
+
+		_scheduler.advance(_cpu.handleInterrupts());
+
+		if (_cpu.getPollingLoopPeriod() != 0)
+			skipPollingLoop(target);
+
+#if defined(DEBUG) || defined(_DEBUG)
+		if (*_cpu.getPC() == _breakpoint)
+			_tracing = true;
+		if (_tracing)
+			_cpu.printRegisters();
+#endif
+	}
+
+	AGE_PROFILE_SCOPE(PS_EVENTS);
+	_scheduler.dispatchEvents();
+}
+
+void Emulator::skipPollingLoop(const cycle_t target)
+{
+	const cycle_t period = _cpu.getPollingLoopPeriod();
+	const cycle_t limit  = std::min(_scheduler.getNextDeadline(), target);
+
+	// Whole trips round the loop up to the next event, each one reading and doing exactly the same.
+	// Every skipped instruction starts before the event, just as it would have when stepped through
+	if (_scheduler.getNow() < limit)
+	{
+		const cycle_t cycles = (limit - _scheduler.getNow()) / period * period;
+		_cpu.idle(cycles);
+		_scheduler.advance(cycles);
+		AGE_PROFILE_COUNT(loopSkips);
+	}
+
+	_cpu.resetPollingLoop();
+}
+
+bool Emulator::applyState(const std::vector<byte>& state)
+{
+	StateReader reader(state);
+
+	if (reader.readDword() != STATE_MAGIC || reader.readDword() != STATE_VERSION)
+		return false;
+
+	std::string cartName(reader.readWord(), '\0');
+	if (!cartName.empty())
+		reader.readBlock(&cartName[0], cartName.size());
+
+	const dword cartChecksum = reader.readDword();
+
+	if (!reader.isValid() || cartName != _memory.getCartName() || cartChecksum != _memory.getCartChecksum())
+		return false;
+
+	_scheduler.deserialize(reader);
+	_input.deserialize(reader);
+	_timer.deserialize(reader);
+	_display.deserialize(reader);
+	_memory.deserialize(reader);
+	_cpu.deserialize(reader);
+
+	return reader.isValid() && reader.isAtEnd();
+}
+
+void Emulator::connectSystems()
+{
+	_memory.setPcRef(_cpu.getPC());
+	_input.setMemory(&_memory);
+	_timer.setMemory(&_memory);
+}
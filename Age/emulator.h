@@ -0,0 +1,70 @@
+#pragma once
+
+#include "common.h"
+#include "scheduler.h"
+#include "input.h"
+#include "timer.h"
+#include "display.h"
+#include "memory.h"
+#include "cpu.h"
+#include "jit.h"
+
+#include <string>
+#include <vector>
+
+class Emulator final
+{
+public:
+	static const word NO_BREAKPOINT = 0xFFFF;
+
+	static const dword STATE_MAGIC   = 0x53454741; // "AGES"
+	static const dword STATE_VERSION = 3;
+
+public:
+	Emulator(Display::fill_displays_callback_t fillDisplayCallback);
+
+	bool loadRom(const std::string& romPath);
+	void loadRom(const std::vector<char>& romData);
+	void reset();
+
+	// Leaving the frame out shrinks a state by the 90KB picture, it is redrawn by running on from there
+	void saveState(std::vector<byte>& state, const bool includeFrame = true) const;
+	bool loadState(const std::vector<byte>& state);
+
+	cycle_t runFor(const cycle_t cycles);
+	cycle_t runFrame();
+
+	void setBreakpoint(const word address);
+	void setSkipBios(const bool skipBios);
+
+	// Runs hot code through the x86-64 translator, false when the host can't
+	bool setJitEnabled(const bool enabled);
+	bool isRomLoaded() const;
+
+	Scheduler& getScheduler();
+	Input& getInput();
+	Timer& getTimer();
+	Display& getDisplay();
+	Memory& getMemory();
+	Cpu& getCpu();
+
+private:
+	void runSlice(const cycle_t target);
+	void skipPollingLoop(const cycle_t target);
+	bool applyState(const std::vector<byte>& state);
+	void connectSystems();
+
+private:
+	Scheduler _scheduler;
+	Input     _input;
+	Timer     _timer;
+	Display   _display;
+	Memory    _memory;
+	Cpu       _cpu;
+	Jit       _jit;
+
+	word _breakpoint;
+	bool _tracing;
+	bool _skipBios;
+	bool _romLoaded;
+};
@@ -1,11 +1,11 @@
 #include "input.h"
 #include "memory.h"
-
-#include <SDL_keyboard.h>
+#include "state.h"
 
 Input::Input()
 	: _keys{0x0F, 0x0F}
 	, _column(0)
+	, _memory(nullptr)
 {
 }
 
@@ -16,9 +16,23 @@ void Input::resetInput()
 	_column  = 0;
 }
 
-void Input::setIFRef(byte* intFlag)
+void Input::serialize(StateWriter& writer) const
+{
+	writer.writeByte(_keys[0]);
+	writer.writeByte(_keys[1]);
+	writer.writeByte(_column);
+}
+
+void Input::deserialize(StateReader& reader)
+{
+	_keys[0] = reader.readByte();
+	_keys[1] = reader.readByte();
+	_column  = reader.readByte();
+}
+
+void Input::setMemory(Memory* const memory)
 {
-	_intFlag = intFlag;
+	_memory = memory;
 }
 
 byte Input::readByte(const word addr)
@@ -37,32 +51,32 @@ void Input::writeByte(const word addr, const byte val)
 	_column = val & 0x30;
 }
 
-void Input::keyDown(const int key)
+void Input::keyDown(const gameboy_key key)
 {
 	switch (key)
 	{
-		case SDLK_LEFT:      _keys[1] &= 0xD; *_intFlag |= Memory::INTERRUPT_FLAG_JOYPAD; break; 
-		case SDLK_RIGHT:     _keys[1] &= 0xE; *_intFlag |= Memory::INTERRUPT_FLAG_JOYPAD; break;
-		case SDLK_UP:        _keys[1] &= 0xB; *_intFlag |= Memory::INTERRUPT_FLAG_JOYPAD; break;
-		case SDLK_DOWN:      _keys[1] &= 0x7; *_intFlag |= Memory::INTERRUPT_FLAG_JOYPAD; break;
-		case SDLK_x:         _keys[0] &= 0xD; *_intFlag |= Memory::INTERRUPT_FLAG_JOYPAD; break;
-		case SDLK_z:         _keys[0] &= 0xE; *_intFlag |= Memory::INTERRUPT_FLAG_JOYPAD; break;
-		case SDLK_RETURN:    _keys[0] &= 0x7; *_intFlag |= Memory::INTERRUPT_FLAG_JOYPAD; break;
-		case SDLK_BACKSPACE: _keys[0] &= 0xB; *_intFlag |= Memory::INTERRUPT_FLAG_JOYPAD; break;
+		case GK_LEFT:   _keys[1] &= 0xD; _memory->requestInterrupt(Memory::INTERRUPT_FLAG_JOYPAD); break; 
+		case GK_RIGHT:  _keys[1] &= 0xE; _memory->requestInterrupt(Memory::INTERRUPT_FLAG_JOYPAD); break;
+		case GK_UP:     _keys[1] &= 0xB; _memory->requestInterrupt(Memory::INTERRUPT_FLAG_JOYPAD); break;
+		case GK_DOWN:   _keys[1] &= 0x7; _memory->requestInterrupt(Memory::INTERRUPT_FLAG_JOYPAD); break;
+		case GK_B:      _keys[0] &= 0xD; _memory->requestInterrupt(Memory::INTERRUPT_FLAG_JOYPAD); break;
+		case GK_A:      _keys[0] &= 0xE; _memory->requestInterrupt(Memory::INTERRUPT_FLAG_JOYPAD); break;
+		case GK_START:  _keys[0] &= 0x7; _memory->requestInterrupt(Memory::INTERRUPT_FLAG_JOYPAD); break;
+		case GK_SELECT: _keys[0] &= 0xB; _memory->requestInterrupt(Memory::INTERRUPT_FLAG_JOYPAD); break;
 	}
 }
 
-void Input::keyUp(const int key)
+void Input::keyUp(const gameboy_key key)
 {
 	switch (key)
 	{
-		case SDLK_LEFT:      _keys[1] |= 0x2; *_intFlag |= Memory::INTERRUPT_FLAG_JOYPAD; break;
-		case SDLK_RIGHT:     _keys[1] |= 0x1; *_intFlag |= Memory::INTERRUPT_FLAG_JOYPAD; break;
-		case SDLK_UP:        _keys[1] |= 0x4; *_intFlag |= Memory::INTERRUPT_FLAG_JOYPAD; break;
-		case SDLK_DOWN:      _keys[1] |= 0x8; *_intFlag |= Memory::INTERRUPT_FLAG_JOYPAD; break;
-		case SDLK_x:         _keys[0] |= 0x2; *_intFlag |= Memory::INTERRUPT_FLAG_JOYPAD; break;
-		case SDLK_z:         _keys[0] |= 0x1; *_intFlag |= Memory::INTERRUPT_FLAG_JOYPAD; break;
-		case SDLK_RETURN:    _keys[0] |= 0x8; *_intFlag |= Memory::INTERRUPT_FLAG_JOYPAD; break;
-		case SDLK_BACKSPACE: _keys[0] |= 0x4; *_intFlag |= Memory::INTERRUPT_FLAG_JOYPAD; break;
+		case GK_LEFT:   _keys[1] |= 0x2; _memory->requestInterrupt(Memory::INTERRUPT_FLAG_JOYPAD); break;
+		case GK_RIGHT:  _keys[1] |= 0x1; _memory->requestInterrupt(Memory::INTERRUPT_FLAG_JOYPAD); break;
+		case GK_UP:     _keys[1] |= 0x4; _memory->requestInterrupt(Memory::INTERRUPT_FLAG_JOYPAD); break;
+		case GK_DOWN:   _keys[1] |= 0x8; _memory->requestInterrupt(Memory::INTERRUPT_FLAG_JOYPAD); break;
+		case GK_B:      _keys[0] |= 0x2; _memory->requestInterrupt(Memory::INTERRUPT_FLAG_JOYPAD); break;
+		case GK_A:      _keys[0] |= 0x1; _memory->requestInterrupt(Memory::INTERRUPT_FLAG_JOYPAD); break;
+		case GK_START:  _keys[0] |= 0x8; _memory->requestInterrupt(Memory::INTERRUPT_FLAG_JOYPAD); break;
+		case GK_SELECT: _keys[0] |= 0x4; _memory->requestInterrupt(Memory::INTERRUPT_FLAG_JOYPAD); break;
 	}
 }
\ No newline at end of file
@@ -2,24 +2,43 @@
 
 #include "common.h"
 
+class Memory;
+class StateReader;
+class StateWriter;
 class Input
 {
+public:
+	enum gameboy_key
+	{
+		GK_RIGHT,
+		GK_LEFT,
+		GK_UP,
+		GK_DOWN,
+		GK_A,
+		GK_B,
+		GK_SELECT,
+		GK_START
+	};
+
 public:
 	Input();
 
 	void resetInput();
 
-	void setIFRef(byte* intFlag);
+	void setMemory(Memory* const memory);
 
-	void keyDown(const int key);
-	void keyUp(const int key);
+	void keyDown(const gameboy_key key);
+	void keyUp(const gameboy_key key);
 
 	byte readByte(const word addr);
 	void writeByte(const word addr, const byte val);
 
+	void serialize(StateWriter& writer) const;
+	void deserialize(StateReader& reader);
+
 private:
 
-	byte  _keys[2];
-	byte  _column;
-	byte* _intFlag;
+	byte    _keys[2];
+	byte    _column;
+	Memory* _memory;
 };
@@ -0,0 +1,432 @@
+#include "jit.h"
+#include "scheduler.h"
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define JIT_X64
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+#endif
+
+using translation_t = void (*)(Cpu*, cycle_t*);
+
+// Most code only ever runs a handful of times, translating it would cost more than it saves
+static const dword HOT_BLOCK_EXECUTIONS = 32;
+
+// Everything is thrown away when the buffer fills up, a translation never takes more than the maximum
+static const size_t CODE_BUFFER_SIZE     = 4 * 1024 * 1024;
+static const size_t MAX_TRANSLATION_SIZE = 2048;
+
+// Stack space below the two saved registers that keeps calls 16 byte aligned, plus the home area on Windows
+#if defined(_WIN32)
+static const byte STACK_RESERVE = 40;
+#else
+static const byte STACK_RESERVE = 8;
+#endif
+
+// Ops that leave memory, control flow and interrupts alone, so they can run back to back with nothing
+// outside the cpu able to tell. Reads are fine as the clock keeps up with them. Anything else ends a translation
+bool Jit::canLeadTranslation(const Cpu::decoded_op& op)
+{
+	const byte opcode = op.opcode;
+
+	// Everything but the shifts, RES and SET on (HL)
+	if (op.isBitOpcode)
+		return (opcode & 7) != 6 || (opcode >= 0x40 && opcode < 0x80);
+
+	// LD r, r' apart from the stores to (HL) and HALT
+	if (opcode >= 0x40 && opcode < 0x80)
+		return opcode < 0x70 || opcode > 0x77;
+
+	// ALU A, r
+	if (opcode >= 0x80 && opcode < 0xC0)
+		return true;
+
+	switch (opcode)
+	{
+		case 0x00:                                                                   // NOP
+		case 0x01: case 0x11: case 0x21: case 0x31:                                  // LD rr, nn
+		case 0x03: case 0x13: case 0x23: case 0x33:                                  // INC rr
+		case 0x0B: case 0x1B: case 0x2B: case 0x3B:                                  // DEC rr
+		case 0x09: case 0x19: case 0x29: case 0x39:                                  // ADD HL, rr
+		case 0x04: case 0x0C: case 0x14: case 0x1C: case 0x24: case 0x2C: case 0x3C: // INC r
+		case 0x05: case 0x0D: case 0x15: case 0x1D: case 0x25: case 0x2D: case 0x3D: // DEC r
+		case 0x06: case 0x0E: case 0x16: case 0x1E: case 0x26: case 0x2E: case 0x3E: // LD r, n
+		case 0x07: case 0x0F: case 0x17: case 0x1F:                                  // RLCA, RRCA, RLA, RRA
+		case 0x27: case 0x2F: case 0x37: case 0x3F:                                  // DAA, CPL, SCF, CCF
+		case 0x0A: case 0x1A: case 0x2A: case 0x3A:                                  // LD A, (rr)
+		case 0xF0: case 0xF2: case 0xFA:                                             // LDH A, (n), LD A, (C), LD A, (nn)
+		case 0xC1: case 0xD1: case 0xE1: case 0xF1:                                  // POP rr
+		case 0xE8: case 0xF8: case 0xF9:                                             // ADD SP, n, LDHL SP, n, LD SP, HL
+		case 0xC6: case 0xCE: case 0xD6: case 0xDE: case 0xE6: case 0xEE: case 0xF6: case 0xFE: // ALU A, n
+			return true;
+	}
+
+	return false;
+}
+
+static byte* allocateCode()
+{
+#if defined(JIT_X64) && defined(_WIN32)
+	return static_cast<byte*>(VirtualAlloc(nullptr, CODE_BUFFER_SIZE, MEM_COMMIT | MEM_RESERVE, PAGE_EXECUTE_READWRITE));
+#elif defined(JIT_X64)
+	void* code = mmap(nullptr, CODE_BUFFER_SIZE, PROT_READ | PROT_WRITE | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	return code != MAP_FAILED ? static_cast<byte*>(code) : nullptr;
+#else
+	return nullptr;
+#endif
+}
+
+static void freeCode(byte* code)
+{
+#if defined(JIT_X64) && defined(_WIN32)
+	VirtualFree(code, 0, MEM_RELEASE);
+#elif defined(JIT_X64)
+	munmap(code, CODE_BUFFER_SIZE);
+#endif
+}
+
+Jit::Jit(Cpu& cpu, Scheduler& scheduler)
+	: _cpu(cpu)
+	, _scheduler(scheduler)
+	, _code(nullptr)
+	, _emit(nullptr)
+	, _codeUsed(0)
+	, _enabled(false)
+{
+}
+
+Jit::~Jit()
+{
+	if (_code != nullptr)
+		freeCode(_code);
+}
+
+bool Jit::setEnabled(const bool enabled)
+{
+	if (enabled && _code == nullptr)
+		_code = allocateCode();
+
+	_enabled = enabled && _code != nullptr;
+	return _enabled == enabled;
+}
+
+bool Jit::isEnabled() const
+{
+	return _enabled;
+}
+
+dword Jit::run(const cycle_t limit)
+{
+	Cpu& cpu = _cpu;
+
+	// Translations start where blocks do, part way through one the interpreter carries on
+	if (cpu._halted || cpu._nextOp->address == cpu._registers.pc)
+		return 0;
+
+	// handleInterrupts has just run everywhere but at the start of a slice, where a pending
+	// interrupt has to be taken after the first instruction rather than the whole block
+	if ((*cpu._raisedInterrupts & cpu._interruptMask) != 0)
+		return 0;
+
+	Cpu::decoded_block& block = cpu.findBlock(cpu._registers.pc);
+
+	// A lone instruction runs no faster translated, so those are left to the interpreter for good
+	if (block.version != 0 && block.translation == nullptr && ++block.executions == HOT_BLOCK_EXECUTIONS &&
+		block.ops[1].handler != nullptr && canLeadTranslation(block.ops[0]))
+		translate(block);
+
+	// Every instruction has to start before the next event, just as when stepping through them
+	if (block.translation == nullptr || block.version == 0 || _scheduler.getNow() + block.translatedLeadCycles >= limit)
+	{
+		cpu._nextOp = block.ops;
+		return 0;
+	}
+
+	reinterpret_cast<translation_t>(block.translation)(&cpu, _scheduler.getNowPtr());
+
+	cpu._nextOp = &Cpu::s_blockEnd;
+	return block.translatedOps;
+}
+
+void Jit::flush()
+{
+	for (Cpu::decoded_block& block: _cpu._blocks)
+		block.translation = nullptr;
+
+	_codeUsed = 0;
+}
+
+void Jit::translate(Cpu::decoded_block& block)
+{
+	if (CODE_BUFFER_SIZE - _codeUsed < MAX_TRANSLATION_SIZE)
+		flush();
+
+	byte* const start = _code + _codeUsed;
+	_emit = start;
+
+	// push rbx, push r12, sub rsp: rbx holds the cpu and r12 the clock for the whole translation
+	emitByte(0x53);
+	emitByte(0x41); emitByte(0x54);
+	emitByte(0x48); emitByte(0x83); emitByte(0xEC); emitByte(STACK_RESERVE);
+#if defined(_WIN32)
+	emitByte(0x48); emitByte(0x89); emitByte(0xCB); // mov rbx, rcx
+	emitByte(0x49); emitByte(0x89); emitByte(0xD4); // mov r12, rdx
+#else
+	emitByte(0x48); emitByte(0x89); emitByte(0xFB); // mov rbx, rdi
+	emitByte(0x49); emitByte(0x89); emitByte(0xF4); // mov r12, rsi
+#endif
+
+	const dword pcOffset        = getOffset(&_cpu._registers.pc);
+	const dword immediateOffset = getOffset(&_cpu._immediate);
+
+	byte count      = 0;
+	dword leadTicks = 0;
+	dword pendingM  = 0;
+	dword pendingT  = 0;
+
+	for (;;)
+	{
+		const Cpu::decoded_op& op = block.ops[count++];
+		const bool isLast         = block.ops[count].handler == nullptr || !canLeadTranslation(op);
+
+		// Simple register moves are done right here, the clock catches up before the next handler
+		const byte length = translateInline(op);
+		if (length != 0)
+		{
+			pendingM += op.m;
+			pendingT += op.t;
+
+			if (isLast)
+			{
+				emitAddCycles(pendingM, pendingT);
+				emitStoreWord(pcOffset, static_cast<word>(op.address + length));
+				emitLastOp(op);
+				break;
+			}
+		}
+		else
+		{
+			emitAddCycles(pendingM, pendingT);
+			pendingM = 0;
+			pendingT = 0;
+
+			if (!op.isBitOpcode)
+				emitStoreWord(immediateOffset, op.immediate);
+			emitStoreWord(pcOffset, static_cast<word>(op.address + (op.isBitOpcode ? 2 : 1)));
+
+			if (isLast)
+			{
+				// Branches only know what they cost once they have run
+				emitLastOp(op);
+				emitCall((op.isBitOpcode ? Cpu::s_cbOpcodes : Cpu::s_coreOpcodes)[op.opcode].thunk);
+				emitAddLastCycles();
+				break;
+			}
+
+			emitCall((op.isBitOpcode ? Cpu::s_cbOpcodes : Cpu::s_coreOpcodes)[op.opcode].thunk);
+			pendingM += op.m;
+			pendingT += op.t;
+		}
+
+		leadTicks += op.t;
+	}
+
+	// add rsp, pop r12, pop rbx, ret
+	emitByte(0x48); emitByte(0x83); emitByte(0xC4); emitByte(STACK_RESERVE);
+	emitByte(0x41); emitByte(0x5C);
+	emitByte(0x5B);
+	emitByte(0xC3);
+
+	block.translation          = start;
+	block.translatedOps        = count;
+	block.translatedLeadCycles = static_cast<byte>(leadTicks);
+	_codeUsed += static_cast<size_t>(_emit - start);
+}
+
+// Register loads that need no flags, returns the op length or 0 when it is left to its handler
+byte Jit::translateInline(const Cpu::decoded_op& op)
+{
+	const byte opcode = op.opcode;
+	if (op.isBitOpcode)
+		return 0;
+
+	if (opcode == 0x00)
+		return 1;
+
+	const byte dst = (opcode >> 3) & 7;
+	const byte src = opcode & 7;
+
+	// LD r, r'
+	if (opcode >= 0x40 && opcode < 0x80 && dst != 6 && src != 6)
+	{
+		if (dst != src)
+		{
+			emitRegisterAccess(0x8A, getRegisterOffset(src)); // mov al, [rbx + src]
+			emitRegisterAccess(0x88, getRegisterOffset(dst)); // mov [rbx + dst], al
+		}
+		return 1;
+	}
+
+	// LD r, n
+	if (opcode < 0x40 && src == 6 && dst != 6)
+	{
+		emitStoreByte(getRegisterOffset(dst), static_cast<byte>(op.immediate));
+		return 2;
+	}
+
+	// LD rr, nn, stored high register first
+	switch (opcode)
+	{
+		case 0x01:
+		case 0x11:
+		case 0x21:
+		{
+			emitStoreByte(getRegisterOffset(dst), static_cast<byte>(op.immediate >> 8));
+			emitStoreByte(getRegisterOffset(dst + 1), static_cast<byte>(op.immediate));
+		} return 3;
+
+		case 0x31:
+		{
+			emitStoreWord(getOffset(&_cpu._registers.sp), op.immediate);
+		} return 3;
+	}
+
+	return 0;
+}
+
+void Jit::emitByte(const byte val)
+{
+	*_emit++ = val;
+}
+
+void Jit::emitDword(const dword val)
+{
+	for (byte i = 0; i < 4; ++i)
+		emitByte(static_cast<byte>(val >> (i * 8)));
+}
+
+void Jit::emitQword(const unsigned long long val)
+{
+	for (byte i = 0; i < 8; ++i)
+		emitByte(static_cast<byte>(val >> (i * 8)));
+}
+
+// opcode al, [rbx + offset] and the other way round
+void Jit::emitRegisterAccess(const byte opcode, const dword offset)
+{
+	emitByte(opcode);
+	emitByte(0x83);
+	emitDword(offset);
+}
+
+void Jit::emitStoreByte(const dword offset, const byte val)
+{
+	emitByte(0xC6);
+	emitByte(0x83);
+	emitDword(offset);
+	emitByte(val);
+}
+
+void Jit::emitStoreWord(const dword offset, const word val)
+{
+	emitByte(0x66);
+	emitByte(0xC7);
+	emitByte(0x83);
+	emitDword(offset);
+	emitByte(static_cast<byte>(val));
+	emitByte(static_cast<byte>(val >> 8));
+}
+
+void Jit::emitStoreTimer(const dword offset, const dword val)
+{
+	if (sizeof(timer_t) == 8)
+		emitByte(0x48);
+	emitByte(0xC7);
+	emitByte(0x83);
+	emitDword(offset);
+	emitDword(val);
+}
+
+void Jit::emitAddCycles(const dword m, const dword t)
+{
+	if (t == 0)
+		return;
+
+	// add qword [r12], t
+	emitByte(0x49); emitByte(0x81); emitByte(0x04); emitByte(0x24);
+	emitDword(t);
+
+	// add [rbx + _internalT], t and add [rbx + _internalM], m
+	const dword offsets[] = { getOffset(&_cpu._internalT), getOffset(&_cpu._internalM) };
+	const dword values[]  = { t, m };
+	for (byte i = 0; i < 2; ++i)
+	{
+		if (sizeof(timer_t) == 8)
+			emitByte(0x48);
+		emitByte(0x81);
+		emitByte(0x83);
+		emitDword(offsets[i]);
+		emitDword(values[i]);
+	}
+}
+
+void Jit::emitAddLastCycles()
+{
+	const byte rex = sizeof(timer_t) == 8 ? 0x48 : 0x00;
+
+	// mov rax, [rbx + T], add [r12], rax, add [rbx + _internalT], rax. A 32 bit load clears the top half
+	if (rex) emitByte(rex);
+	emitRegisterAccess(0x8B, getOffset(&_cpu._registers.T));
+	emitByte(0x49); emitByte(0x01); emitByte(0x04); emitByte(0x24);
+	if (rex) emitByte(rex);
+	emitRegisterAccess(0x01, getOffset(&_cpu._internalT));
+
+	// mov rax, [rbx + M], add [rbx + _internalM], rax
+	if (rex) emitByte(rex);
+	emitRegisterAccess(0x8B, getOffset(&_cpu._registers.M));
+	if (rex) emitByte(rex);
+	emitRegisterAccess(0x01, getOffset(&_cpu._internalM));
+}
+
+void Jit::emitCall(Cpu::opcode_thunk_t thunk)
+{
+#if defined(_WIN32)
+	emitByte(0x48); emitByte(0x89); emitByte(0xD9); // mov rcx, rbx
+#else
+	emitByte(0x48); emitByte(0x89); emitByte(0xDF); // mov rdi, rbx
+#endif
+	emitByte(0x48); emitByte(0xB8);                 // mov rax, thunk
+	emitQword(reinterpret_cast<unsigned long long>(thunk));
+	emitByte(0xFF); emitByte(0xD0);                 // call rax
+}
+
+// What the interpreter leaves behind of the last instruction it ran
+void Jit::emitLastOp(const Cpu::decoded_op& op)
+{
+	emitStoreByte(getOffset(&_cpu._opcode), op.opcode);
+	emitStoreByte(getOffset(&_cpu._isBitOpcode), op.isBitOpcode ? 1 : 0);
+	emitStoreTimer(getOffset(&_cpu._registers.M), op.m);
+	emitStoreTimer(getOffset(&_cpu._registers.T), op.t);
+}
+
+dword Jit::getOffset(const void* field) const
+{
+	return static_cast<dword>(static_cast<const byte*>(field) - reinterpret_cast<const byte*>(&_cpu));
+}
+
+// Operand encoding of bits 0-2 and 3-5, without (HL)
+dword Jit::getRegisterOffset(const byte operand) const
+{
+	const Cpu::registers& registers = _cpu._registers;
+	const byte* const fields[] = { &registers.B, &registers.C, &registers.D, &registers.E, &registers.H, &registers.L, nullptr, &registers.A };
+	return getOffset(fields[operand]);
+}
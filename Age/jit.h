@@ -0,0 +1,59 @@
+#pragma once
+
+#include "common.h"
+#include "cpu.h"
+
+#include <cstddef>
+
+class Scheduler;
+
+// Optional x86-64 backend for the cpu. Decoded blocks that keep being run get translated into native code
+// calling the same opcode handlers back to back, with the clock kept running in between so reads see the
+// time they would in the interpreter. Only the last op of a translation may write memory, branch or touch
+// interrupts, so the interpreter's view of the world is exact again at every block exit.
+// Translations live as long as their decoded block, which already follows bank switches and code writes.
+class Jit final
+{
+public:
+	Jit(Cpu& cpu, Scheduler& scheduler);
+	~Jit();
+
+	// Not every host can run generated code, false leaves everything to the interpreter
+	bool setEnabled(const bool enabled);
+	bool isEnabled() const;
+
+	// Runs the translation of the block starting at pc if it is hot and all of it starts before limit.
+	// Returns how many instructions it ran, 0 leaves the next one to the interpreter
+	dword run(const cycle_t limit);
+
+	void flush();
+
+private:
+	static bool canLeadTranslation(const Cpu::decoded_op& op);
+
+	void translate(Cpu::decoded_block& block);
+	byte translateInline(const Cpu::decoded_op& op);
+
+	void emitByte(const byte val);
+	void emitDword(const dword val);
+	void emitQword(const unsigned long long val);
+	void emitRegisterAccess(const byte opcode, const dword offset);
+	void emitStoreByte(const dword offset, const byte val);
+	void emitStoreWord(const dword offset, const word val);
+	void emitStoreTimer(const dword offset, const dword val);
+	void emitAddCycles(const dword m, const dword t);
+	void emitAddLastCycles();
+	void emitCall(Cpu::opcode_thunk_t thunk);
+	void emitLastOp(const Cpu::decoded_op& op);
+
+	dword getOffset(const void* field) const;
+	dword getRegisterOffset(const byte operand) const;
+
+private:
+	Cpu&       _cpu;
+	Scheduler& _scheduler;
+	byte*      _code;
+	byte*      _emit;
+	size_t     _codeUsed;
+	bool       _enabled;
+};
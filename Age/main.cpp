@@ -1,20 +1,25 @@
 #include <vld.h>
 
 #include "common.h"
-#include "memory.h"
-#include "display.h"
-#include "cpu.h"
-#include "input.h"
+#include "emulator.h"
+#include "pacer.h"
+#include "rewind.h"
+#include "triplebuffer.h"
 #include "window.h"
 
 #include <iostream>
-#include <fstream>
-#include <vector>
 #include <cstring>
 #include <SDL.h>
 #include <SDL_image.h>
 
+#include <atomic>
+#include <chrono>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 
 //#define CURR_ADDRESS_TO_BREAK 0x1FFA
 //#define CURR_ADDRESS_TO_BREAK 0x02C6
@@ -22,121 +27,194 @@
 
 static const char* DEBUG_FLAG = "-d";
 
-static SDL_Surface*  mainViewSurface;
-static SDL_Surface*  tileViewSurface;
-static SDL_Surface*  spriteViewSurface;
+// Everything the frontend draws into, owned by main and handed to the display callback
+struct frontend_views
+{
+	std::unique_ptr<Window> mainView;
+	std::unique_ptr<Window> tileView;
+	std::unique_ptr<Window> spriteView;
+};
+
+// What commands posted by the frontend get to work with on the emulation thread
+struct emulation_context
+{
+	Emulator&   emulator;
+	Rewind&     rewind;
+	FramePacer& pacer;
+};
 
-static std::unique_ptr<Window> tileView;
-static std::unique_ptr<Window> spriteView;
-static std::unique_ptr<Window> mainView;
+using emulation_command_t = std::function<void(emulation_context&)>;
 
-void loadRom(const char* const arg, Memory& memory)
+// Everything the frontend and the emulation thread share. The emulator itself is only ever
+// touched by the emulation thread, the frontend posts commands that it runs between frames
+struct emulation_link
 {
-	std::ifstream file;
-	file.open(arg, std::ios::binary|std::ios::ate);
-	if (file.is_open())
-	{
-		std::ifstream::pos_type pos = file.tellg();
-		std::vector<char> programData(static_cast<int>(pos));
+	TripleBuffer                     frames;
+	std::mutex                       mutex;
+	std::vector<emulation_command_t> commands;
+	std::string                      cartName;
+	bool                             cartChanged = false;
+	std::atomic<bool>                running{true};
+	std::atomic<bool>                rewinding{false};
+	std::atomic<bool>                inspecting{false};
+};
 
-		file.seekg(0, std::ios::beg);
-		file.read(&programData[0], pos);
-		
-		memory.fillRom(programData);
+bool translateKey(const int sdlKey, Input::gameboy_key& key)
+{
+	switch (sdlKey)
+	{
+		case SDLK_LEFT:      key = Input::GK_LEFT; return true;
+		case SDLK_RIGHT:     key = Input::GK_RIGHT; return true;
+		case SDLK_UP:        key = Input::GK_UP; return true;
+		case SDLK_DOWN:      key = Input::GK_DOWN; return true;
+		case SDLK_x:         key = Input::GK_B; return true;
+		case SDLK_z:         key = Input::GK_A; return true;
+		case SDLK_RETURN:    key = Input::GK_START; return true;
+		case SDLK_BACKSPACE: key = Input::GK_SELECT; return true;
 	}
+
+	return false;
 }
 
-void fillDisplay(byte* gfxData, byte* tileGfx, byte* spriteGfx)
+void postCommand(emulation_link& link, emulation_command_t command)
 {
-	// Fill graphics and render main view
-	SDL_FreeSurface(mainViewSurface);
-	mainViewSurface = SDL_CreateRGBSurfaceFrom(
-		static_cast<void*>(gfxData),
-		160, 144,
-		8 * Display::DISPLAY_DEPTH,
-		Display::DISPLAY_COLS * Display::DISPLAY_DEPTH,
-		0x000000FF,
-		0x0000FF00,
-		0x00FF0000,
-		0xFF000000
-	);
-	
-	mainView->setTextureFromSurface(mainViewSurface);
-	mainView->render();
+	std::lock_guard<std::mutex> lock(link.mutex);
+	link.commands.push_back(command);
+}
 
-	// Fill graphics and render tile view
+void fillDisplay(frontend_views& views, const display_frame& frame)
+{
+	// Upload straight into each view's streaming texture and render it
+	views.mainView->updateTexture(frame.gfx, Display::DISPLAY_COLS, Display::DISPLAY_ROWS);
+	views.mainView->render();
 
 #if defined(DEBUG) || defined(_DEBUG)
-	if (tileView)
+	if (views.tileView)
 	{
-		SDL_FreeSurface(tileViewSurface);
-		tileViewSurface = SDL_CreateRGBSurfaceFrom(
-			static_cast<void*>(tileGfx),
-			Display::DISPLAY_TILE_VIEW_BASE_WIDTH, Display::DISPLAY_TILE_VIEW_BASE_HEIGHT,
-			8 * Display::DISPLAY_DEPTH,
-			Display::DISPLAY_TILE_VIEW_BASE_WIDTH * Display::DISPLAY_DEPTH,
-			0x000000FF,
-			0x0000FF00,
-			0x00FF0000,
-			0xFF000000);
-
-		tileView->setTextureFromSurface(tileViewSurface);
-		tileView->render();
+		views.tileView->updateTexture(frame.tileGfx, Display::DISPLAY_TILE_VIEW_BASE_WIDTH, Display::DISPLAY_TILE_VIEW_BASE_HEIGHT);
+		views.tileView->render();
 	}
 	
-	// Fill graphics and render sprite view
-	if (spriteView)
+	if (views.spriteView)
 	{
-		SDL_FreeSurface(spriteViewSurface);
-		spriteViewSurface = SDL_CreateRGBSurfaceFrom(
-			static_cast<void*>(spriteGfx),
-			Display::DISPLAY_SPRITE_VIEW_BASE_WIDTH, Display::DISPLAY_SPRITE_VIEW_BASE_HEIGHT,
-			8 * Display::DISPLAY_DEPTH,
-			Display::DISPLAY_SPRITE_VIEW_BASE_WIDTH * Display::DISPLAY_DEPTH,
-			0x000000FF,
-			0x0000FF00,
-			0x00FF0000,
-			0xFF000000);
-
-		spriteView->setTextureFromSurface(spriteViewSurface);
-		spriteView->render();
+		views.spriteView->updateTexture(frame.spriteGfx, Display::DISPLAY_SPRITE_VIEW_BASE_WIDTH, Display::DISPLAY_SPRITE_VIEW_BASE_HEIGHT);
+		views.spriteView->render();
 	}
 #endif
 }
 
+void runEmulation(emulation_link& link)
+{
+	// Finished frames are copied out at vblank, presenting them is up to the frontend
+	bool framePending = false;
+	Emulator emulator([&link, &framePending](byte* gfxData)
+	{
+		display_frame& frame = link.frames.getWriteFrame();
+		memcpy(frame.gfx, gfxData, sizeof(frame.gfx));
+		framePending = true;
+	});
+	emulator.setBreakpoint(CURR_ADDRESS_TO_BREAK);
+	emulator.getDisplay().setRenderInterval(Display::RENDER_ON_REQUEST);
+
+	Rewind rewind;
+	FramePacer pacer;
+	emulation_context context{ emulator, rewind, pacer };
+
+	std::vector<byte> rewindState;
+	std::vector<emulation_command_t> commands;
+
+	while (link.running)
+	{
+		{
+			std::lock_guard<std::mutex> lock(link.mutex);
+			commands.swap(link.commands);
+		}
+
+		for (emulation_command_t& command: commands)
+			command(context);
+
+		commands.clear();
+
+		if (!emulator.isRomLoaded())
+		{
+			// Nothing to run until a rom is dropped in
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+			continue;
+		}
+
+		// Frames the pacer is going to skip over are never drawn, let alone handed to the frontend
+		const bool present = pacer.shouldPresent();
+		if (present)
+			emulator.getDisplay().requestFrame();
+
+		// Every frame ends right after vblank has been published, which is where history is recorded
+		if (link.rewinding)
+		{
+			// Holding R plays the recorded history backwards, one frame per frame
+			if (rewind.stepBack(rewindState))
+			{
+				emulator.loadState(rewindState);
+
+				// History leaves the picture out, so the frame that followed is drawn by running it again.
+				// Going back to the recorded state afterwards keeps the next step and resuming exact
+				if (present)
+				{
+					emulator.runFrame();
+					emulator.loadState(rewindState);
+				}
+			}
+
+			pacer.endFrame(Display::FULL_FRAME_TIME);
+		}
+		else
+		{
+			const cycle_t cycles = emulator.runFrame();
+			emulator.saveState(rewindState, false);
+			rewind.push(rewindState);
+
+			pacer.endFrame(cycles);
+		}
+
+		if (framePending)
+		{
+			// Debug views are only drawn while a viewer is open, and only redrawn when tiles or OAM changed
+			if (link.inspecting)
+			{
+				display_frame& frame = link.frames.getWriteFrame();
+				memcpy(frame.tileGfx,   emulator.getDisplay().getTileView(),   sizeof(frame.tileGfx));
+				memcpy(frame.spriteGfx, emulator.getDisplay().getSpriteView(), sizeof(frame.spriteGfx));
+			}
+
+			link.frames.publish();
+			framePending = false;
+		}
+	}
+
+	pacer.printHistogram();
+}
+
 int main(int argc, char* argv[])
 {	
 	// Initialize SDL
 	// TODO: Handle Errors
 	SDL_Init(SDL_INIT_EVERYTHING);
 	SDL_EventState(SDL_DROPFILE, SDL_ENABLE);
-	
-	mainView   = std::make_unique<Window>(592, 540, 894, 30, "A.G.E");
+
+	frontend_views views;
+	views.mainView   = std::make_unique<Window>(592, 540, 894, 30, "A.G.E");
 	
 #ifdef _DEBUG
-	tileView   = std::make_unique<Window>(Display::DISPLAY_TILE_VIEW_BASE_WIDTH * 2, Display::DISPLAY_TILE_VIEW_BASE_HEIGHT* 2, 638, 30, "Tile View");
-	spriteView = std::make_unique<Window>(Display::DISPLAY_SPRITE_VIEW_BASE_WIDTH * 8,  Display::DISPLAY_SPRITE_VIEW_BASE_HEIGHT * 8, 382, 445, "Sprite View");	
+	views.tileView   = std::make_unique<Window>(Display::DISPLAY_TILE_VIEW_BASE_WIDTH * 2, Display::DISPLAY_TILE_VIEW_BASE_HEIGHT* 2, 638, 30, "Tile View");
+	views.spriteView = std::make_unique<Window>(Display::DISPLAY_SPRITE_VIEW_BASE_WIDTH * 8,  Display::DISPLAY_SPRITE_VIEW_BASE_HEIGHT * 8, 382, 445, "Sprite View");	
 #endif
 
-	// Initialize Core Systems
-	Input input;
-	Display display(fillDisplay);
-	Memory memory(display, input);
-	Cpu cpu(memory);
-
-	// Set additional dependencies in core systems
-	memory.setPcRef(cpu.getPC());
-	display.setZ80TimeRegister(cpu.getT());
-	input.setIFRef(memory.getIFPtr());
-
-	// Load Rom
-	//loadRom(argv[1], memory);
-	
+	// Initialize Core Systems on their own thread, so that presenting (and waiting on vsync) never stalls them
+	std::unique_ptr<emulation_link> link = std::make_unique<emulation_link>();
+	link->inspecting = views.tileView || views.spriteView;
+	std::thread emulationThread(runEmulation, std::ref(*link));
 	
 	SDL_Event sdlEvent;
 	bool running = true;
-	bool hasRomBeenLoaded = false;
-	bool shouldPrint      = false;
 	bool spacePressed     = false;
 	bool spacePressed0    = false;
 	bool aPressed         = false;
@@ -144,12 +222,8 @@ int main(int argc, char* argv[])
 	bool sPressed         = false;
 	bool sPressed0        = false;
 	
-	word pcHistory[10000];
-	word pcHistoryIndex = 0;
-	
-	SDL_SetWindowTitle(mainView->getWindowHandle(), "Drag n' Drop a ROM file inside this window!");
+	SDL_SetWindowTitle(views.mainView->getWindowHandle(), "Drag n' Drop a ROM file inside this window!");
 
-	int i = 0;
 	while (running)
 	{
 		while (SDL_PollEvent(&sdlEvent))
@@ -159,12 +233,12 @@ int main(int argc, char* argv[])
 				case SDL_QUIT: running = false; break;
 				case SDL_WINDOWEVENT: 
 				{
-					if (mainView)
-						mainView->handleEvent(sdlEvent);
-					if (tileView)
-						tileView->handleEvent(sdlEvent);
-					if (spriteView)
-						spriteView->handleEvent(sdlEvent);
+					if (views.mainView)
+						views.mainView->handleEvent(sdlEvent);
+					if (views.tileView)
+						views.tileView->handleEvent(sdlEvent);
+					if (views.spriteView)
+						views.spriteView->handleEvent(sdlEvent);
 				} break;
 				case SDL_KEYDOWN:
 				{
@@ -173,8 +247,19 @@ int main(int argc, char* argv[])
 						case SDLK_SPACE: spacePressed = true; break;
 						case SDLK_a: aPressed = true; break;
 						case SDLK_s: sPressed = true; break;
+						case SDLK_r: link->rewinding = true; break;
+						case SDLK_1: postCommand(*link, [](emulation_context& context) { context.pacer.setMode(PM_REALTIME); }); break;
+						case SDLK_2: postCommand(*link, [](emulation_context& context) { context.pacer.setMode(PM_MULTIPLIER, 2); }); break;
+						case SDLK_3: postCommand(*link, [](emulation_context& context) { context.pacer.setMode(PM_MULTIPLIER, 4); }); break;
+						case SDLK_0: postCommand(*link, [](emulation_context& context) { context.pacer.setMode(PM_UNCAPPED); }); break;
+						case SDLK_h: postCommand(*link, [](emulation_context& context) { context.pacer.printHistogram(); context.pacer.resetHistogram(); }); break;
 						case SDLK_ESCAPE: running = false; break;
-						default: input.keyDown(sdlEvent.key.keysym.sym);
+						default: 
+						{
+							Input::gameboy_key key;
+							if (translateKey(sdlEvent.key.keysym.sym, key))
+								postCommand(*link, [key](emulation_context& context) { context.emulator.getInput().keyDown(key); });
+						}
 					}
 					
 				} break;
@@ -185,7 +270,13 @@ int main(int argc, char* argv[])
 						case SDLK_SPACE: spacePressed = false; break;
 						case SDLK_a: aPressed = false; break;
 						case SDLK_s: sPressed = false; break;
-						default: input.keyUp(sdlEvent.key.keysym.sym);
+						case SDLK_r: link->rewinding = false; break;
+						default:
+						{
+							Input::gameboy_key key;
+							if (translateKey(sdlEvent.key.keysym.sym, key))
+								postCommand(*link, [key](emulation_context& context) { context.emulator.getInput().keyUp(key); });
+						}
 					}
 				} break;
 
@@ -199,83 +290,92 @@ int main(int argc, char* argv[])
 
 				case SDL_DROPFILE:
 				{
-					char* droppedRomPath = sdlEvent.drop.file;					
-					memory.resetMemory();
-					cpu.resetCpu();
-					input.resetInput();
-					display.resetDisplay();
-					memory.setPcRef(cpu.getPC());
-					display.setZ80TimeRegister(cpu.getT());
-					input.setIFRef(memory.getIFPtr());
-					loadRom(droppedRomPath, memory);
-					hasRomBeenLoaded = true;					
-					SDL_free(droppedRomPath);
-
-					SDL_SetWindowTitle(mainView->getWindowHandle(), ("Emulating: " + memory.getCartName()).c_str());
+					const std::string droppedRomPath = sdlEvent.drop.file;
+					SDL_free(sdlEvent.drop.file);
+
+					emulation_link& shared = *link;
+					postCommand(shared, [droppedRomPath, &shared](emulation_context& context)
+					{
+						context.emulator.loadRom(droppedRomPath);
+						context.rewind.clear();
+						context.pacer.reset();
+
+						std::lock_guard<std::mutex> lock(shared.mutex);
+						shared.cartName    = context.emulator.getMemory().getCartName();
+						shared.cartChanged = true;
+					});
 				} break;
 			}
 		}
 
 #if defined (DEBUG) || defined(_DEBUG)
-		if (*cpu.getPC() == CURR_ADDRESS_TO_BREAK)
-		{			
-			shouldPrint = true;
-		}
-		
-		
 		if (aPressed && !aPressed0)
 		{
-			byte lcdc = memory.readByte(0xFF40);
-			if (lcdc & 0x01)
-				memory.writeByte(0xFF40, lcdc & ~0x01);
-			else
-				memory.writeByte(0xFF40, lcdc | 0x01);
+			postCommand(*link, [](emulation_context& context)
+			{
+				Memory& memory = context.emulator.getMemory();
+
+				byte lcdc = memory.readByte(0xFF40);
+				if (lcdc & 0x01)
+					memory.writeByte(0xFF40, lcdc & ~0x01);
+				else
+					memory.writeByte(0xFF40, lcdc | 0x01);
+			});
 		}
 
 		if (sPressed & !sPressed0)
 		{
-			byte lcdc = memory.readByte(0xFF40);
-			if (lcdc & 0x20)
-				memory.writeByte(0xFF40, lcdc & ~0x20);
-			else
-				memory.writeByte(0xFF40, lcdc | 0x20);
+			postCommand(*link, [](emulation_context& context)
+			{
+				Memory& memory = context.emulator.getMemory();
+
+				byte lcdc = memory.readByte(0xFF40);
+				if (lcdc & 0x20)
+					memory.writeByte(0xFF40, lcdc & ~0x20);
+				else
+					memory.writeByte(0xFF40, lcdc | 0x20);
+			});
 		}
 #endif
-		if (hasRomBeenLoaded)
 		{
-			cpu.emulateCycle();
-			pcHistory[pcHistoryIndex] = *cpu.getPC();
-			if (pcHistory[pcHistoryIndex] == pcHistory[pcHistoryIndex - 1])
+			std::lock_guard<std::mutex> lock(link->mutex);
+			if (link->cartChanged)
 			{
-				const auto b = false;
+				SDL_SetWindowTitle(views.mainView->getWindowHandle(), ("Emulating: " + link->cartName).c_str());
+				link->cartChanged = false;
 			}
-			pcHistoryIndex = (pcHistoryIndex + 1) % 10000;
-			cpu.handleInterrupts();
-			display.emulateGameboyDisplay();
-		}		
+		}
+
+		// Present the newest finished frame, any the host was too slow for are skipped over
+		if (link->frames.acquire())
+			fillDisplay(views, link->frames.getReadFrame());
+		else
+			SDL_Delay(1);
 			
 #if defined (_DEBUG) || defined (DEBUG)
-		if (shouldPrint)
-			cpu.printRegisters();
-
 		spacePressed0 = spacePressed;
 		aPressed0 = aPressed;
 		sPressed0 = sPressed;
 
-		if (mainView && mainView->isDestroyed())
+		if (views.mainView && views.mainView->isDestroyed())
 		{
-			mainView = nullptr;
+			views.mainView = nullptr;
 			running  = false;
 		}
-		if (tileView && tileView->isDestroyed()) 
+		if (views.tileView && views.tileView->isDestroyed()) 
 		{
-			tileView = nullptr;
+			views.tileView = nullptr;
 		}
-		if (spriteView && spriteView->isDestroyed()) 
+		if (views.spriteView && views.spriteView->isDestroyed()) 
 		{
-			spriteView = nullptr;
+			views.spriteView = nullptr;
 		}
+
+		link->inspecting = views.tileView || views.spriteView;
 #endif
 	}
+
+	link->running = false;
+	emulationThread.join();
 	return 0;
 }
\ No newline at end of file
@@ -1,12 +1,18 @@
 #include "memory.h"
 #include "display.h"
 #include "input.h"
+#include "state.h"
+#include "timer.h"
 
-#include <ctime>
-#include <random>
 #include <iostream>
 #include <memory>
 
+// ROM code versions are fixed per bank, RAM ones are handed out from above them every time a page changes
+static const code_version_t BIOS_CODE_VERSION      = 1;
+static const code_version_t ROM0_CODE_VERSION      = 2;
+static const code_version_t ROM_BANK_CODE_VERSION  = 3;
+static const code_version_t FIRST_RAM_CODE_VERSION = 0x10000;
+
 static const byte i_bios[256] = 
 {
 	0x31, 0xFE, 0xFF, 0xAF, 0x21, 0xFF, 0x9F, 0x32, 0xCB, 0x7C, 0x20, 0xFB, 0x21, 0x26, 0xFF, 0x0E,
@@ -27,12 +33,16 @@ static const byte i_bios[256] =
 	0xF5, 0x06, 0x19, 0x78, 0x86, 0x23, 0x05, 0x20, 0xFB, 0x86, 0x20, 0xFE, 0x3E, 0x01, 0xE0, 0x50
 };
 
-Memory::Memory(Display& displayRef, Input& inputRef)
-	: _pcref(nullptr)
-	, _displayRef(displayRef)
-	, _inputRef(inputRef)
+Memory::Memory(Display& displayRef, Input& inputRef, Timer& timerRef)
+	: _rom(nullptr)
 	, _ie(0)
 	, _if(0)
+	, _raisedInterrupts(0)
+	, _nextCodeVersion(FIRST_RAM_CODE_VERSION)
+	, _pcref(nullptr)
+	, _displayRef(displayRef)
+	, _inputRef(inputRef)
+	, _timerRef(timerRef)
 {
 	resetMemory();
 	_displayRef.setMemory(this);
@@ -45,19 +55,24 @@ Memory::~Memory()
 }
 
 byte Memory::readByte(const word addr)
+{
+	const byte* page = _readPages[addr >> 8];
+	if (page)
+		return page[addr & 0xFF];
+
+	return readUnmappedByte(addr);
+}
+
+byte Memory::readUnmappedByte(const word addr)
 {	
 	switch (addr & 0xF000)
 	{
 		// BIOS 256 (ROM0)
 		case 0x0000:
 		{
-			if (_inbios == 1)
-			{
-				if (addr < 0x0100)
-					return _bios[addr];
-				if (*_pcref >= 0x0100)
-					_inbios = 0;				
-			}
+			// Only reachable while the bios is mapped over the first page
+			if (_inbios == 1 && addr < 0x0100)
+				return _bios[addr];
 
 			return _rom[addr];
 		} break;
@@ -126,14 +141,8 @@ byte Memory::readByte(const word addr)
 							//std::cout << "At: 0x" << std::hex << *_pcref << " unimplemented serial transfer read " << std::hex << addr << " reading from iom instead" << std::endl;
 							return _iomem[addr & 0x7F];
 						}
-						else if (addr == 0xFF04)
-						{							
-							return _iomem[addr & 0x7F];
-						}
-						else if (addr == 0xFF05 || addr == 0xFF06 || addr == 0xFF07)
-						{							
-							return _iomem[addr & 0x7F];
-						}
+						else if (addr >= 0xFF04 && addr <= 0xFF07)
+							return _timerRef.readByte(addr);
 						else if (addr == 0xFF0F)
 							return _if;
 					} break;
@@ -171,6 +180,21 @@ byte Memory::retrieveFromVram(const word addr)
 }
 
 void Memory::writeByte(const word addr, const byte val)
+{
+	byte* page = _writePages[addr >> 8];
+	if (page)
+	{
+		page[addr & 0xFF] = val;
+		return;
+	}
+
+	if (_codeWatched[addr >> 8])
+		invalidateCode(addr >> 8);
+
+	writeUnmappedByte(addr, val);
+}
+
+void Memory::writeUnmappedByte(const word addr, const byte val)
 {
 	if (addr == 0x9106 && val == 0x06)
 		const auto b = false;
@@ -208,7 +232,8 @@ void Memory::writeByte(const word addr, const byte val)
 
 						_mbcState.ROMBank = (_mbcState.ROMBank & 0x60) + lo5;
 						word prevOffset = _mbcState.ROMOffset;
-						_mbcState.ROMOffset = _mbcState.ROMBank * 0x4000;										
+						_mbcState.ROMOffset = _mbcState.ROMBank * 0x4000;
+						mapRomBank();
 
 					} break;
 
@@ -224,6 +249,7 @@ void Memory::writeByte(const word addr, const byte val)
 						//_mbcState.ROMBank &= 39;
 						word prevOffset = _mbcState.ROMOffset;
 						_mbcState.ROMOffset = _mbcState.ROMBank * 0x4000;
+						mapRomBank();
 						
 					} break;
 				}
@@ -243,13 +269,15 @@ void Memory::writeByte(const word addr, const byte val)
 						{
 							// RAM mode: Set Bank (0-3)
 							_mbcState.RAMBank = val & 0x3;
-							_mbcState.RAMOffset = _mbcState.RAMBank * 0x2000;							
+							_mbcState.RAMOffset = _mbcState.RAMBank * 0x2000;
+							mapRamBank();
 						}
 						else
 						{
 							// ROM mode: Set High bits of bank
 							_mbcState.ROMBank = (_mbcState.ROMBank & 0x1F) + ((val & 0x3) << 5);
-							_mbcState.ROMOffset = _mbcState.ROMBank * 0x4000;							
+							_mbcState.ROMOffset = _mbcState.ROMBank * 0x4000;
+							mapRomBank();
 						}
 					} break;
 
@@ -260,6 +288,7 @@ void Memory::writeByte(const word addr, const byte val)
 							_mbcState.RAMBank = val;
 							_mbcState.RAMBank &= 3;
 							_mbcState.RAMOffset = _mbcState.RAMBank * 0x2000;
+							mapRamBank();
 						}
 					} break;
 				} 
@@ -310,22 +339,8 @@ void Memory::normalWriteByte(const word addr, const byte val)
 
 			if (addr > 0x97FF) return;
 
-			// Update tileset
-			const word baseAddress = addr & 0x1FFE;
-			const word tile        = (addr >> 4) & 0x1FF;
-			const word y           = (addr >> 1) & 7;
-
-			byte bitIndex = 0;
-
-			for (byte x = 0; x < 8; ++x)
-			{
-				bitIndex = 1 << (7 - x);
-				byte color = ((_vram[baseAddress] & bitIndex) != 0 ? 1 : 0) +
-					         ((_vram[baseAddress + 1] & bitIndex) != 0 ? 2 : 0);
-
-				_displayRef.changeTileData(tile, x, y, color);
-			}
-			
+			// The display re-decodes the tile the next time it is drawn
+			_displayRef.invalidateTile((addr >> 4) & 0x1FF);
 		} break;
 
 		// WRAM (8k)
@@ -368,16 +383,13 @@ void Memory::normalWriteByte(const word addr, const byte val)
 							std::cout << "At: 0x" << std::hex << *_pcref << " unimplemented serial transfer write " << std::hex << addr << " dumping to iom instead" << std::endl;
 							_iomem[addr & 0x7F] = val;
 						}
-						else if (addr == 0xFF04)
-						{							
-							_iomem[addr & 0x7F] = 0;
-						}
-						else if (addr == 0xFF05 || addr == 0xFF06 || addr == 0xFF07)
-						{							
-							_iomem[addr & 0x7F] = val;
-						}
+						else if (addr >= 0xFF04 && addr <= 0xFF07)
+							_timerRef.writeByte(addr, val);
 						else if (addr == 0xFF0F)
-							_if = val; 
+						{
+							_if = val;
+							updateRaisedInterrupts();
+						}
 					} break;
 					case 0x40:
 					{
@@ -394,6 +406,18 @@ void Memory::normalWriteByte(const word addr, const byte val)
 							_displayRef.writeByte(addr, val);
 					} break;
 
+					case 0x50:
+					{
+						// The bios unmaps itself by writing to 0xFF50 right before jumping to the cart
+						if (addr == 0xFF50 && val != 0 && _inbios == 1)
+						{
+							_inbios = 0;
+							mapPages();
+						}
+
+						_iomem[addr & 0x7F] = val;
+					} break;
+
 					default:
 						//std::cout << "At: 0x" << std::hex << *_pcref << " unhandled write to: 0x" << std::hex << addr << " dumping to iom" << std::endl;
 						_iomem[addr & 0x7F] = val;
@@ -404,6 +428,7 @@ void Memory::normalWriteByte(const word addr, const byte val)
 			else
 			{
 				_ie = val;
+				updateRaisedInterrupts();
 			}
 		} break;
 	}
@@ -420,26 +445,106 @@ byte Memory::getCurrentRomBank() const
 	return _mbcState.ROMBank;
 }
 
-void Memory::incrementDiv()
+code_version_t Memory::getCodeVersion(const word addr) const
+{
+	// The top page is HRAM between the I/O registers and IE
+	if (addr >= 0xFF00 && (addr < 0xFF80 || addr == 0xFFFF))
+		return 0;
+
+	return _codeVersions[addr >> 8];
+}
+
+void Memory::watchCode(const word addr)
+{
+	const word page = addr >> 8;
+	if (page >= 0xC0 && !_codeWatched[page])
+		setCodeWatched(page, true);
+}
+
+void Memory::setCodeChangedCallback(code_changed_callback_t callback)
+{
+	_codeChangedCallback = callback;
+}
+
+void Memory::invalidateCode(const word page)
 {
-	_iomem[0x04]++;
+	// The shadow shares its WRAM page's code, so both move on together
+	const word codePage = page >= 0xE0 && page < 0xFE ? page - 0x20 : page;
+
+	_codeVersions[codePage] = _nextCodeVersion++;
+	if (codePage < 0xDE)
+		_codeVersions[codePage + 0x20] = _codeVersions[codePage];
+
+	setCodeWatched(codePage, false);
+
+	if (_codeChangedCallback)
+		_codeChangedCallback();
+}
+
+void Memory::setCodeWatched(const word page, const bool watched)
+{
+	const word codePage = page >= 0xE0 && page < 0xFE ? page - 0x20 : page;
+
+	// HRAM writes always take the slow path, WRAM ones are pulled off the fast path along with the shadow's
+	_codeWatched[codePage] = watched;
+	if (codePage < 0xE0)
+	{
+		_writePages[codePage] = watched ? nullptr : _readPages[codePage];
+		if (codePage < 0xDE)
+		{
+			_codeWatched[codePage + 0x20] = watched;
+			_writePages[codePage + 0x20]  = _writePages[codePage];
+		}
+	}
+}
+
+void Memory::skipBios()
+{
+	// I/O state the bios leaves behind when it hands over to the cart
+	writeByte(0xFF40, 0x91);
+	writeByte(0xFF47, 0xFC);
+	writeByte(0xFF48, 0xFF);
+	writeByte(0xFF49, 0xFF);
+	writeByte(0xFF50, 0x01);
 }
 
 bool Memory::inBios() const { return _inbios != 0; }
 byte Memory::getIE() const { return _ie; }
 byte Memory::getIF() const { return _if; }
-byte* Memory::getIEPtr() { return &_ie; }
-byte* Memory::getIFPtr() { return &_if; }
 
 const std::string& Memory::getCartName() const
 {
 	return _cartName;
 }
 
-void Memory::resetInterrupt(const byte interrupt) { _if &= ~interrupt; }
+dword Memory::getCartChecksum() const
+{
+	// Header checksum followed by the big endian global checksum
+	return _rom ? (_rom[0x014D] << 16) | (_rom[0x014E] << 8) | _rom[0x014F] : 0;
+}
+
+void Memory::requestInterrupt(const byte interrupt)
+{
+	_if |= interrupt;
+	updateRaisedInterrupts();
+}
+
+void Memory::resetInterrupt(const byte interrupt)
+{
+	_if &= ~interrupt;
+	updateRaisedInterrupts();
+}
+
+const byte* Memory::getRaisedInterruptsPtr() const { return &_raisedInterrupts; }
+
+void Memory::updateRaisedInterrupts()
+{
+	_raisedInterrupts = _ie & _if & INTERRUPT_FLAGS_ALL;
+}
 
 void Memory::fillRom(const std::vector<char>& romData)
 {
+	free(_rom);
 	_rom = (byte*)malloc(sizeof(byte) * romData.size());
 	memcpy(_rom, &romData[0], romData.size());
 	_cartName.clear();
@@ -450,6 +555,7 @@ void Memory::fillRom(const std::vector<char>& romData)
 
 	_cartType = _rom[0x0147];
 	initMBC();
+	mapPages();
 }
 
 void Memory::setPcRef(const word* pcref) { _pcref = pcref; }
@@ -457,6 +563,7 @@ void Memory::setPcRef(const word* pcref) { _pcref = pcref; }
 void Memory::resetMemory()
 {
 	free(_rom);
+	_rom    = nullptr;
 	_inbios = 1;
 	
 	memcpy(_bios, i_bios, sizeof(_bios));	
@@ -469,23 +576,131 @@ void Memory::resetMemory()
 
 	_ie = 0;
 	_if = 0;
+	updateRaisedInterrupts();
+
+	mapPages();
+}
 
-	std::srand((unsigned int)std::time(NULL));
+void Memory::serialize(StateWriter& writer) const
+{
+	writer.writeByte(_inbios);
+	writer.writeBlock(_vram,  sizeof(_vram));
+	writer.writeBlock(_eram,  sizeof(_eram));
+	writer.writeBlock(_wram,  sizeof(_wram));
+	writer.writeBlock(_oam,   sizeof(_oam));
+	writer.writeBlock(_iomem, sizeof(_iomem));
+	writer.writeBlock(_zram,  sizeof(_zram));
+	writer.writeByte(_ie);
+	writer.writeByte(_if);
+
+	writer.writeByte(_mbcState.ROMBank);
+	writer.writeByte(_mbcState.RAMBank);
+	writer.writeByte(_mbcState.RAMEnabled ? 1 : 0);
+	writer.writeByte(_mbcState.mode ? 1 : 0);
+	writer.writeDword(_mbcState.RAMOffset);
+	writer.writeDword(_mbcState.ROMOffset);
+}
+
+void Memory::deserialize(StateReader& reader)
+{
+	// The rom itself is not part of the state, the cart has to be loaded already
+	_inbios = reader.readByte();
+	reader.readBlock(_vram,  sizeof(_vram));
+	reader.readBlock(_eram,  sizeof(_eram));
+	reader.readBlock(_wram,  sizeof(_wram));
+	reader.readBlock(_oam,   sizeof(_oam));
+	reader.readBlock(_iomem, sizeof(_iomem));
+	reader.readBlock(_zram,  sizeof(_zram));
+	_ie = reader.readByte();
+	_if = reader.readByte();
+	updateRaisedInterrupts();
+
+	_mbcState.ROMBank    = reader.readByte();
+	_mbcState.RAMBank    = reader.readByte();
+	_mbcState.RAMEnabled = reader.readByte() != 0;
+	_mbcState.mode       = reader.readByte() != 0;
+	_mbcState.RAMOffset  = reader.readDword();
+	_mbcState.ROMOffset  = reader.readDword();
+
+	mapPages();
 }
 
 void Memory::initMBC()
 {
-	switch (_cartType)
+	// Every supported cart powers up with bank 1 in the switchable window
+	_mbcState.RAMBank    = 0;
+	_mbcState.ROMBank    = 0;
+	_mbcState.RAMEnabled = false;
+	_mbcState.mode       = false;
+	_mbcState.ROMOffset  = 0x4000;
+	_mbcState.RAMOffset  = 0x0000;
+}
+
+void Memory::mapPages()
+{
+	for (word page = 0; page < PAGE_COUNT; ++page)
+	{
+		_readPages[page]    = nullptr;
+		_writePages[page]   = nullptr;
+		_codeVersions[page] = 0;
+		_codeWatched[page]  = false;
+	}
+
+	if (_inbios)
+		_codeVersions[0x00] = BIOS_CODE_VERSION;
+
+	if (_rom)
 	{
-		case 0x0:
-		case 0x1: 
+		// The first page stays unmapped while the bios overlays it
+		for (word page = _inbios ? 0x01 : 0x00; page < 0x40; ++page)
 		{
-			_mbcState.RAMBank    = 0;
-			_mbcState.ROMBank    = 0;
-			_mbcState.RAMEnabled = false;
-			_mbcState.mode       = false;
-			_mbcState.ROMOffset  = 0x4000;
-			_mbcState.RAMOffset  = 0x0000;
-		} break;
+			_readPages[page]    = _rom + (page << 8);
+			_codeVersions[page] = ROM0_CODE_VERSION;
+		}
+
+		mapRomBank();
+		mapRamBank();
+	}
+
+	// VRAM writes also have to update the tileset, so only reads are mapped
+	for (word page = 0x80; page < 0xA0; ++page)
+		_readPages[page] = _vram + ((page & 0x1F) << 8);
+
+	// WRAM and its shadow up to OAM
+	for (word page = 0xC0; page < 0xFE; ++page)
+	{
+		_readPages[page]  = _wram + ((page & 0x1F) << 8);
+		_writePages[page] = _readPages[page];
+	}
+
+	// Remapped RAM may hold anything now, the shadow follows the WRAM page it mirrors
+	for (word page = 0xC0; page < 0xFE; ++page)
+		_codeVersions[page] = page < 0xE0 ? _nextCodeVersion++ : _codeVersions[page - 0x20];
+
+	_codeVersions[0xFF] = _nextCodeVersion++;
+
+	if (_codeChangedCallback)
+		_codeChangedCallback();
+}
+
+void Memory::mapRomBank()
+{
+	for (word page = 0x40; page < 0x80; ++page)
+	{
+		_readPages[page]    = _rom + _mbcState.ROMOffset + ((page & 0x3F) << 8);
+		_codeVersions[page] = ROM_BANK_CODE_VERSION + (_mbcState.ROMOffset >> 14);
+	}
+
+	if (_codeChangedCallback)
+		_codeChangedCallback();
+}
+
+void Memory::mapRamBank()
+{
+	// Carts without an MBC drop ERAM writes, so those stay on the unmapped path
+	for (word page = 0xA0; page < 0xC0; ++page)
+	{
+		_readPages[page]  = _eram + _mbcState.RAMOffset + ((page & 0x1F) << 8);
+		_writePages[page] = _cartType != 0 ? _readPages[page] : nullptr;
 	}
 }
\ No newline at end of file
@@ -6,11 +6,16 @@
 #include <functional>
 
 class Input;
+class Timer;
 class Display;
+class StateReader;
+class StateWriter;
 class Memory final
 {
 public:
-	Memory(Display&, Input&);
+	using code_changed_callback_t = std::function<void()>;
+
+	Memory(Display&, Input&, Timer&);
 	~Memory();
 
 	byte readByte(const word addr);
@@ -18,30 +23,45 @@ public:
 	word readWord(const word addr);
 	byte getCurrentRomBank() const;
 
+	// Identifies the code at an address for the cpu's decode cache. It changes whenever the bytes there
+	// could, ROM with the bank and watched RAM on every write, and is 0 where nothing may be cached
+	code_version_t getCodeVersion(const word addr) const;
+	void watchCode(const word addr);
+	void setCodeChangedCallback(code_changed_callback_t callback);
+
 	void normalWriteByte(const word addr, const byte val);
 	void writeByte(const word addr, const byte val);
 	void writeWord(const word addr, const word val);
-	void incrementDiv();
 
+	void skipBios();
 	bool inBios() const;
 	byte getIE() const;
 	byte getIF() const;
-	byte* getIEPtr();
-	byte* getIFPtr();
+
+	// Every change to IE or IF goes through here or a register write, which keep IE & IF up to date for the cpu
+	void requestInterrupt(const byte interrupt);
+	void resetInterrupt(const byte interrupt);
+	const byte* getRaisedInterruptsPtr() const;
 	
 	const std::string& getCartName() const;
+	dword getCartChecksum() const;
 
-	void resetInterrupt(const byte interrupt);
 	void fillRom(const std::vector<char>& romData);
 	void setPcRef(const word* pcref);
 	void resetMemory();
 
+	void serialize(StateWriter& writer) const;
+	void deserialize(StateReader& reader);
+
 public:
 	static const byte INTERRUPT_FLAG_VBLANK    = 0x01;
 	static const byte INTERRUPT_FLAG_TOGGLELCD = 0x02;
 	static const byte INTERRUPT_FLAG_TIMER     = 0x04;
 	static const byte INTERRUPT_FLAG_SERIAL    = 0x08;
 	static const byte INTERRUPT_FLAG_JOYPAD    = 0x10;
+	static const byte INTERRUPT_FLAGS_ALL      = 0x1F;
+
+	static const word PAGE_COUNT = 256;
 
 private:
 
@@ -59,25 +79,45 @@ private:
 private:
 
 	void initMBC();
+	byte readUnmappedByte(const word addr);
+	void writeUnmappedByte(const word addr, const byte val);
+	void mapPages();
+	void mapRomBank();
+	void mapRamBank();
+	void invalidateCode(const word page);
+	void setCodeWatched(const word page, const bool watched);
+	void updateRaisedInterrupts();
 
 private:
 	byte _inbios;
 	byte _bios[256];
 	byte* _rom;
 	byte _vram[8192];
-	byte _eram[8192];
+	byte _eram[32768];
 	byte _wram[8192];
 	byte _oam[160];
 	byte _iomem[128];
 	byte _zram[128];	
 	byte _ie;
 	byte _if;
+	byte _raisedInterrupts;
 	byte _cartType;
 
+	// Host pointers to the start of each 256 byte page, null pages go through the unmapped handlers
+	byte* _readPages[PAGE_COUNT];
+	byte* _writePages[PAGE_COUNT];
+
+	// Watched RAM pages hold cached code, their writes are routed off the fast path to catch them
+	code_version_t          _codeVersions[PAGE_COUNT];
+	bool                    _codeWatched[PAGE_COUNT];
+	code_version_t          _nextCodeVersion;
+	code_changed_callback_t _codeChangedCallback;
+
 	std::string _cartName;
 
 	mbc_state_t _mbcState;
 	const word* _pcref;
 	Display& _displayRef;
 	Input& _inputRef;
+	Timer& _timerRef;
 };
\ No newline at end of file
@@ -0,0 +1,131 @@
+#include "pacer.h"
+#include "display.h"
+
+#include <iostream>
+#include <iomanip>
+#include <thread>
+
+static const cycle_t CLOCK_FREQUENCY = 4194304;
+
+// Sleeping is only trusted to wake up within this much of the deadline, the rest is spun out
+static const std::chrono::microseconds SPIN_MARGIN(1500);
+
+// Falling further behind than this is not caught up on, the deadline restarts from now
+static const cycle_t MAX_LAG_FRAMES = 4;
+
+FramePacer::FramePacer()
+	: _mode(PM_REALTIME)
+	, _multiplier(1)
+{
+	reset();
+	resetHistogram();
+}
+
+void FramePacer::setMode(const pacing_mode mode, const dword multiplier)
+{
+	_mode       = mode;
+	_multiplier = multiplier > 0 ? multiplier : 1;
+	reset();
+}
+
+pacing_mode FramePacer::getMode() const { return _mode; }
+dword FramePacer::getMultiplier() const { return _multiplier; }
+
+bool FramePacer::shouldPresent() const
+{
+	return _presentNext;
+}
+
+void FramePacer::endFrame(const cycle_t cycles)
+{
+	const duration_t frameDuration = getHostDuration(Display::FULL_FRAME_TIME);
+
+	if (_mode != PM_UNCAPPED)
+	{
+		_deadline += _mode == PM_MULTIPLIER ? getHostDuration(cycles) / _multiplier : getHostDuration(cycles);
+
+		const host_clock_t::time_point now = host_clock_t::now();
+		if (now > _deadline + frameDuration * MAX_LAG_FRAMES)
+			_deadline = now;
+		else
+			waitUntil(_deadline);
+	}
+
+	const host_clock_t::time_point frameEnd = host_clock_t::now();
+	const cycle_t micros = std::chrono::duration_cast<std::chrono::microseconds>(frameEnd - _lastFrameEnd).count();
+
+	++_histogram[micros / HISTOGRAM_BUCKET_MICROS < HISTOGRAM_BUCKETS ? micros / HISTOGRAM_BUCKET_MICROS : HISTOGRAM_BUCKETS - 1];
+	_lastFrameEnd = frameEnd;
+
+	// Present at most once per Game Boy frame of host time, intermediate frames are never shown
+	switch (_mode)
+	{
+		case PM_REALTIME:   _presentNext = true; break;
+		case PM_MULTIPLIER: _presentNext = ++_framesSincePresent >= _multiplier; break;
+		case PM_UNCAPPED:   _presentNext = frameEnd - _lastPresent >= frameDuration; break;
+	}
+
+	if (_presentNext)
+	{
+		_framesSincePresent = 0;
+		_lastPresent        = frameEnd;
+	}
+}
+
+void FramePacer::reset()
+{
+	_deadline     = host_clock_t::now();
+	_lastFrameEnd = _deadline;
+	_lastPresent  = _deadline;
+	_presentNext  = true;
+
+	_framesSincePresent = 0;
+}
+
+const cycle_t* FramePacer::getHistogram() const
+{
+	return _histogram;
+}
+
+void FramePacer::resetHistogram()
+{
+	for (dword i = 0; i < HISTOGRAM_BUCKETS; ++i)
+		_histogram[i] = 0;
+}
+
+void FramePacer::printHistogram() const
+{
+	cycle_t frames = 0;
+	for (dword i = 0; i < HISTOGRAM_BUCKETS; ++i)
+		frames += _histogram[i];
+
+	std::cout << std::dec << "Frame times over " << frames << " frames" << std::endl;
+
+	for (dword i = 0; i < HISTOGRAM_BUCKETS; ++i)
+	{
+		if (_histogram[i] == 0)
+			continue;
+
+		const double from = i * HISTOGRAM_BUCKET_MICROS / 1000.0;
+		std::cout << std::fixed << std::setprecision(1) << std::setw(6) << from << (i + 1 < HISTOGRAM_BUCKETS ? " ms " : " ms+")
+		          << std::setw(8) << _histogram[i] << "  " << std::string(static_cast<size_t>(_histogram[i] * 50 / frames), '#') << std::endl;
+	}
+
+	std::cout << std::defaultfloat;
+}
+
+FramePacer::duration_t FramePacer::getHostDuration(const cycle_t cycles) const
+{
+	return duration_t(cycles * 1000000000ULL / CLOCK_FREQUENCY);
+}
+
+void FramePacer::waitUntil(const host_clock_t::time_point deadline) const
+{
+	// Sleep for the bulk of the wait, then spin the last stretch for an accurate wake up
+	const host_clock_t::time_point now = host_clock_t::now();
+	if (deadline - now > SPIN_MARGIN)
+		std::this_thread::sleep_for(deadline - now - SPIN_MARGIN);
+
+	while (host_clock_t::now() < deadline)
+		std::this_thread::yield();
+}
\ No newline at end of file
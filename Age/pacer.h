@@ -0,0 +1,54 @@
+#pragma once
+
+#include "common.h"
+
+#include <chrono>
+
+enum pacing_mode
+{
+	PM_REALTIME,
+	PM_UNCAPPED,
+	PM_MULTIPLIER
+};
+
+// Keeps emulated time in step with host time. Real time runs frames at the Game Boy's own
+// 59.73 Hz, the multiplier mode at N times that, and uncapped as fast as the host allows.
+// Whenever more frames are run than the host can show, only one per Game Boy frame is presented.
+class FramePacer final
+{
+public:
+	static const dword HISTOGRAM_BUCKETS       = 64;
+	static const dword HISTOGRAM_BUCKET_MICROS = 500;
+
+public:
+	FramePacer();
+
+	void setMode(const pacing_mode mode, const dword multiplier = 1);
+	pacing_mode getMode() const;
+	dword getMultiplier() const;
+
+	bool shouldPresent() const;
+	void endFrame(const cycle_t cycles);
+	void reset();
+
+	const cycle_t* getHistogram() const;
+	void resetHistogram();
+	void printHistogram() const;
+
+private:
+	using host_clock_t = std::chrono::steady_clock;
+	using duration_t   = std::chrono::nanoseconds;
+
+	duration_t getHostDuration(const cycle_t cycles) const;
+	void waitUntil(const host_clock_t::time_point deadline) const;
+
+private:
+	pacing_mode              _mode;
+	dword                    _multiplier;
+	dword                    _framesSincePresent;
+	host_clock_t::time_point _deadline;
+	host_clock_t::time_point _lastFrameEnd;
+	host_clock_t::time_point _lastPresent;
+	bool                     _presentNext;
+	cycle_t                  _histogram[HISTOGRAM_BUCKETS];
+};
\ No newline at end of file
@@ -0,0 +1,163 @@
+#include "pixels.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define PIXELS_X86
+#include <emmintrin.h>
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define PIXELS_TARGET_AVX2
+#else
+#define PIXELS_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+using expand_tile_row_t = void(*)(const byte*, const dword*, byte*);
+
+static void expandTileRowScalar(const byte* colors, const dword* palette, byte* dst)
+{
+	for (byte x = 0; x < 8; ++x)
+	{
+		const dword emucol = palette[colors[x]];
+
+		dst[0] = (emucol & 0x000000FF) >> 0;
+		dst[1] = (emucol & 0x0000FF00) >> 8;
+		dst[2] = (emucol & 0x00FF0000) >> 16;
+		dst[3] = (emucol & 0xFF000000) >> 24;
+		dst += 4;
+	}
+}
+
+#ifdef PIXELS_X86
+static inline __m128i selectBits(const __m128i mask, const __m128i a, const __m128i b)
+{
+	return _mm_or_si128(_mm_andnot_si128(mask, a), _mm_and_si128(mask, b));
+}
+
+static inline __m128i lookupPalette(const __m128i indices, const __m128i* palette)
+{
+	// No variable shuffle in SSE2, so pick between palette entries with the two index bits as masks
+	const __m128i bit0 = _mm_cmpeq_epi32(_mm_and_si128(indices, _mm_set1_epi32(1)), _mm_set1_epi32(1));
+	const __m128i bit1 = _mm_cmpeq_epi32(_mm_and_si128(indices, _mm_set1_epi32(2)), _mm_set1_epi32(2));
+
+	const __m128i low  = selectBits(bit0, palette[0], palette[1]);
+	const __m128i high = selectBits(bit0, palette[2], palette[3]);
+	return selectBits(bit1, low, high);
+}
+
+static void expandTileRowSse2(const byte* colors, const dword* palette, byte* dst)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i indices8  = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(colors));
+	const __m128i indices16 = _mm_unpacklo_epi8(indices8, zero);
+
+	const __m128i entries[4] =
+	{
+		_mm_set1_epi32(static_cast<int>(palette[0])),
+		_mm_set1_epi32(static_cast<int>(palette[1])),
+		_mm_set1_epi32(static_cast<int>(palette[2])),
+		_mm_set1_epi32(static_cast<int>(palette[3]))
+	};
+
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(dst),      lookupPalette(_mm_unpacklo_epi16(indices16, zero), entries));
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 16), lookupPalette(_mm_unpackhi_epi16(indices16, zero), entries));
+}
+
+PIXELS_TARGET_AVX2 static void expandTileRowAvx2(const byte* colors, const dword* palette, byte* dst)
+{
+	// Both 128 bit halves hold the palette so vpermd can index it with the 0-3 color values directly
+	const __m256i entries = _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(palette)));
+	const __m256i table   = _mm256_permute2x128_si256(entries, entries, 0x00);
+	const __m256i indices = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(colors)));
+
+	_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), _mm256_permutevar8x32_epi32(table, indices));
+}
+
+static bool isAvx2Supported()
+{
+#if defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] < 7)
+		return false;
+
+	// AVX2 also needs the OS to preserve the upper halves of the ymm registers
+	__cpuid(info, 1);
+	const bool osxsave = (info[2] & (1 << 27)) != 0;
+	const bool avx     = (info[2] & (1 << 28)) != 0;
+	if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6)
+		return false;
+
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;
+#else
+	return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+
+static bool isSse2Supported()
+{
+#if defined(_M_X64) || defined(__x86_64__)
+	return true;
+#elif defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 1);
+	return (info[3] & (1 << 26)) != 0;
+#else
+	return __builtin_cpu_supports("sse2") != 0;
+#endif
+}
+#endif
+
+static expand_tile_row_t getKernelFunction(const pixel_kernel kernel)
+{
+	switch (kernel)
+	{
+#ifdef PIXELS_X86
+		case PK_AVX2: return expandTileRowAvx2;
+		case PK_SSE2: return expandTileRowSse2;
+#endif
+		default: return expandTileRowScalar;
+	}
+}
+
+static pixel_kernel s_pixelKernel        = getBestPixelKernel();
+static expand_tile_row_t s_expandTileRow = getKernelFunction(s_pixelKernel);
+
+void expandTileRow(const byte* colors, const dword* palette, byte* dst)
+{
+	s_expandTileRow(colors, palette, dst);
+}
+
+pixel_kernel getPixelKernel()
+{
+	return s_pixelKernel;
+}
+
+pixel_kernel getBestPixelKernel()
+{
+#ifdef PIXELS_X86
+	if (isAvx2Supported())
+		return PK_AVX2;
+	if (isSse2Supported())
+		return PK_SSE2;
+#endif
+	return PK_SCALAR;
+}
+
+void setPixelKernel(const pixel_kernel kernel)
+{
+	// Never go wider than what the host can run
+	s_pixelKernel   = kernel > getBestPixelKernel() ? getBestPixelKernel() : kernel;
+	s_expandTileRow = getKernelFunction(s_pixelKernel);
+}
+
+const char* getPixelKernelName(const pixel_kernel kernel)
+{
+	switch (kernel)
+	{
+		case PK_AVX2: return "avx2";
+		case PK_SSE2: return "sse2";
+		default:      return "scalar";
+	}
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "common.h"
+
+// Expansion of decoded tile rows (8 color indices) into RGBA pixels through a 4 entry palette.
+// The widest kernel the host supports is picked on startup. The choice is process wide, so
+// override it before any emulator threads are started.
+
+enum pixel_kernel
+{
+	PK_SCALAR,
+	PK_SSE2,
+	PK_AVX2
+};
+
+void expandTileRow(const byte* colors, const dword* palette, byte* dst);
+
+pixel_kernel getPixelKernel();
+pixel_kernel getBestPixelKernel();
+void setPixelKernel(const pixel_kernel kernel);
+const char* getPixelKernelName(const pixel_kernel kernel);
@@ -0,0 +1,37 @@
+#include "profile.h"
+
+#include <chrono>
+#include <cstring>
+
+// Per thread so that instances running side by side each count only their own work
+static thread_local profile_stats s_profileStats = {};
+
+profile_stats& getProfileStats()
+{
+	return s_profileStats;
+}
+
+void resetProfileStats()
+{
+	memset(&s_profileStats, 0, sizeof(s_profileStats));
+}
+
+#ifdef AGE_PROFILE
+
+static cycle_t getNanoseconds()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+ProfileScope::ProfileScope(const profile_section section)
+	: _section(section)
+	, _start(getNanoseconds())
+{
+}
+
+ProfileScope::~ProfileScope()
+{
+	s_profileStats.sectionNanoseconds[_section] += getNanoseconds() - _start;
+}
+
+#endif
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "common.h"
+
+// Coarse per-subsystem counters for benchmark builds. Everything compiles away unless AGE_PROFILE is defined.
+
+enum profile_section
+{
+	PS_EVENTS,
+	PS_SCANLINE,
+	PS_FRAME_OUTPUT,
+	PS_COUNT
+};
+
+struct profile_stats
+{
+	cycle_t instructions;
+	cycle_t translatedInstructions;
+	cycle_t haltSkips;
+	cycle_t loopSkips;
+	cycle_t scanlines;
+	cycle_t frames;
+	cycle_t sectionNanoseconds[PS_COUNT];
+};
+
+profile_stats& getProfileStats();
+void resetProfileStats();
+
+#ifdef AGE_PROFILE
+
+class ProfileScope final
+{
+public:
+	ProfileScope(const profile_section section);
+	~ProfileScope();
+
+private:
+	const profile_section _section;
+	const cycle_t         _start;
+};
+
+#define AGE_PROFILE_SCOPE(section) ProfileScope profileScope(section)
+#define AGE_PROFILE_COUNT(counter) ++getProfileStats().counter
+#define AGE_PROFILE_ADD(counter, n) getProfileStats().counter += n
+
+#else
+
+#define AGE_PROFILE_SCOPE(section)
+#define AGE_PROFILE_COUNT(counter)
+#define AGE_PROFILE_ADD(counter, n)
+
+#endif
@@ -0,0 +1,138 @@
+#include "rewind.h"
+
+#include <cstring>
+
+// Consecutive frames mostly differ in a few scattered bytes, so the XOR is long runs of zeros.
+// The delta is a sequence of (zero run, literal run, literal bytes), with both run lengths as varints.
+
+static void writeVarint(std::vector<byte>& out, size_t val)
+{
+	while (val >= 0x80)
+	{
+		out.push_back(static_cast<byte>(val | 0x80));
+		val >>= 7;
+	}
+
+	out.push_back(static_cast<byte>(val));
+}
+
+static size_t readVarint(const byte*& in)
+{
+	size_t val   = 0;
+	dword  shift = 0;
+
+	while (*in & 0x80)
+	{
+		val |= static_cast<size_t>(*in++ & 0x7F) << shift;
+		shift += 7;
+	}
+
+	return val | (static_cast<size_t>(*in++) << shift);
+}
+
+Rewind::Rewind(const size_t budget)
+	: _deltaBytes(0)
+	, _budget(budget)
+{
+}
+
+void Rewind::push(const std::vector<byte>& state)
+{
+	// A state of another size means another cart or format, the history no longer applies
+	if (_latest.size() != state.size())
+	{
+		clear();
+		_latest = state;
+		return;
+	}
+
+	// The buffer of the last dropped entry is reused so steady state pushes do not allocate
+	std::vector<byte> delta;
+	delta.swap(_spare);
+	encodeDelta(state, _latest, delta);
+
+	_deltaBytes += delta.size();
+	_deltas.push_back(std::move(delta));
+	_latest = state;
+
+	while (_deltaBytes > _budget && !_deltas.empty())
+	{
+		_deltaBytes -= _deltas.front().size();
+		_spare.swap(_deltas.front());
+		_deltas.pop_front();
+	}
+}
+
+bool Rewind::stepBack(std::vector<byte>& state)
+{
+	if (_deltas.empty())
+		return false;
+
+	// The state before the newest one becomes the newest, so recording resumes from it
+	applyDelta(_deltas.back(), _latest);
+
+	_deltaBytes -= _deltas.back().size();
+	_spare.swap(_deltas.back());
+	_deltas.pop_back();
+
+	state = _latest;
+	return true;
+}
+
+void Rewind::clear()
+{
+	_deltas.clear();
+	_latest.clear();
+	_deltaBytes = 0;
+}
+
+size_t Rewind::getCount() const
+{
+	return _latest.empty() ? 0 : _deltas.size() + 1;
+}
+
+size_t Rewind::getMemoryUsage() const
+{
+	return _deltaBytes + _latest.size();
+}
+
+void Rewind::encodeDelta(const std::vector<byte>& from, const std::vector<byte>& to, std::vector<byte>& delta) const
+{
+	delta.clear();
+
+	const size_t size = from.size();
+	size_t i = 0;
+
+	while (i < size)
+	{
+		const size_t zeroStart = i;
+		while (i < size && from[i] == to[i])
+			++i;
+
+		// A single matching byte inside a literal run is cheaper to copy than to split the run over
+		const size_t literalStart = i;
+		while (i < size && (from[i] != to[i] || (i + 1 < size && from[i + 1] != to[i + 1])))
+			++i;
+
+		writeVarint(delta, literalStart - zeroStart);
+		writeVarint(delta, i - literalStart);
+
+		for (size_t j = literalStart; j < i; ++j)
+			delta.push_back(from[j] ^ to[j]);
+	}
+}
+
+void Rewind::applyDelta(const std::vector<byte>& delta, std::vector<byte>& state) const
+{
+	const byte* in  = delta.data();
+	const byte* end = in + delta.size();
+	byte* out       = state.data();
+
+	while (in < end)
+	{
+		out += readVarint(in);
+
+		for (size_t literals = readVarint(in); literals > 0; --literals)
+			*out++ ^= *in++;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "common.h"
+
+#include <cstddef>
+#include <deque>
+#include <vector>
+
+// History of save states for stepping gameplay backwards. Only the newest state is kept whole,
+// every older one is stored as the run length encoded XOR against the state that followed it.
+// The oldest entries are dropped once the encoded history grows past the memory budget.
+class Rewind final
+{
+public:
+	static const size_t DEFAULT_BUDGET = 8 * 1024 * 1024;
+
+public:
+	Rewind(const size_t budget = DEFAULT_BUDGET);
+
+	void push(const std::vector<byte>& state);
+	bool stepBack(std::vector<byte>& state);
+	void clear();
+
+	size_t getCount() const;
+	size_t getMemoryUsage() const;
+
+private:
+	void encodeDelta(const std::vector<byte>& from, const std::vector<byte>& to, std::vector<byte>& delta) const;
+	void applyDelta(const std::vector<byte>& delta, std::vector<byte>& state) const;
+
+private:
+	std::deque<std::vector<byte>> _deltas;
+	std::vector<byte>             _latest;
+	std::vector<byte>             _spare;
+	size_t                        _deltaBytes;
+	size_t                        _budget;
+};
\ No newline at end of file
@@ -0,0 +1,92 @@
+#include "scheduler.h"
+#include "state.h"
+
+Scheduler::Scheduler()
+{
+	resetScheduler();
+}
+
+void Scheduler::resetScheduler()
+{
+	_now          = 0;
+	_nextDeadline = NO_DEADLINE;
+
+	for (byte i = 0; i < EVENT_COUNT; ++i)
+		_deadlines[i] = NO_DEADLINE;
+}
+
+void Scheduler::serialize(StateWriter& writer) const
+{
+	writer.writeCycle(_now);
+
+	for (byte i = 0; i < EVENT_COUNT; ++i)
+		writer.writeCycle(_deadlines[i]);
+}
+
+void Scheduler::deserialize(StateReader& reader)
+{
+	_now = reader.readCycle();
+
+	for (byte i = 0; i < EVENT_COUNT; ++i)
+		_deadlines[i] = reader.readCycle();
+
+	findNextDeadline();
+}
+
+void Scheduler::setHandler(const event_type event, event_handler_t handler)
+{
+	_handlers[event] = handler;
+}
+
+void Scheduler::schedule(const event_type event, const cycle_t deadline)
+{
+	_deadlines[event] = deadline;
+	findNextDeadline();
+}
+
+void Scheduler::cancel(const event_type event)
+{
+	_deadlines[event] = NO_DEADLINE;
+	findNextDeadline();
+}
+
+void Scheduler::advance(const cycle_t cycles)
+{
+	_now += cycles;
+}
+
+void Scheduler::dispatchEvents()
+{
+	// Handlers get their own deadline rather than the current time so that
+	// rescheduling from it does not accumulate the overshoot of the last instruction
+	while (_nextDeadline <= _now)
+	{
+		byte event = 0;
+		for (byte i = 1; i < EVENT_COUNT; ++i)
+		{
+			if (_deadlines[i] < _deadlines[event])
+				event = i;
+		}
+
+		const cycle_t deadline = _deadlines[event];
+		_deadlines[event] = NO_DEADLINE;
+		findNextDeadline();
+
+		_handlers[event](deadline);
+	}
+}
+
+cycle_t Scheduler::getNow() const { return _now; }
+cycle_t Scheduler::getNextDeadline() const { return _nextDeadline; }
+cycle_t* Scheduler::getNowPtr() { return &_now; }
+
+void Scheduler::findNextDeadline()
+{
+	_nextDeadline = NO_DEADLINE;
+
+	for (byte i = 0; i < EVENT_COUNT; ++i)
+	{
+		if (_deadlines[i] < _nextDeadline)
+			_nextDeadline = _deadlines[i];
+	}
+}
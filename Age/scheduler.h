@@ -0,0 +1,52 @@
+#pragma once
+
+#include "common.h"
+
+#include <functional>
+
+class StateReader;
+class StateWriter;
+class Scheduler final
+{
+public:
+	enum event_type
+	{
+		EVENT_DISPLAY,
+		EVENT_TIMER,
+		EVENT_COUNT
+	};
+
+	static const cycle_t NO_DEADLINE = ~0ULL;
+
+	using event_handler_t = std::function<void(const cycle_t)>;
+
+public:
+	Scheduler();
+
+	void resetScheduler();
+
+	void setHandler(const event_type event, event_handler_t handler);
+	void schedule(const event_type event, const cycle_t deadline);
+	void cancel(const event_type event);
+
+	void advance(const cycle_t cycles);
+	void dispatchEvents();
+
+	cycle_t getNow() const;
+	cycle_t getNextDeadline() const;
+
+	// For generated code that keeps the clock running as it goes
+	cycle_t* getNowPtr();
+
+	void serialize(StateWriter& writer) const;
+	void deserialize(StateReader& reader);
+
+private:
+	void findNextDeadline();
+
+private:
+	cycle_t         _now;
+	cycle_t         _nextDeadline;
+	cycle_t         _deadlines[EVENT_COUNT];
+	event_handler_t _handlers[EVENT_COUNT];
+};
@@ -0,0 +1,51 @@
+#include "state.h"
+
+#include <cstring>
+
+StateWriter::StateWriter(std::vector<byte>& buffer)
+	: _buffer(buffer)
+{
+}
+
+void StateWriter::writeByte(const byte val) { writeBlock(&val, sizeof(val)); }
+void StateWriter::writeWord(const word val) { writeBlock(&val, sizeof(val)); }
+void StateWriter::writeDword(const dword val) { writeBlock(&val, sizeof(val)); }
+void StateWriter::writeCycle(const cycle_t val) { writeBlock(&val, sizeof(val)); }
+
+void StateWriter::writeBlock(const void* data, const size_t size)
+{
+	if (size == 0)
+		return;
+
+	const size_t offset = _buffer.size();
+	_buffer.resize(offset + size);
+	memcpy(&_buffer[offset], data, size);
+}
+
+StateReader::StateReader(const std::vector<byte>& buffer)
+	: _buffer(buffer)
+	, _offset(0)
+	, _valid(true)
+{
+}
+
+byte StateReader::readByte() { byte val; readBlock(&val, sizeof(val)); return val; }
+word StateReader::readWord() { word val; readBlock(&val, sizeof(val)); return val; }
+dword StateReader::readDword() { dword val; readBlock(&val, sizeof(val)); return val; }
+cycle_t StateReader::readCycle() { cycle_t val; readBlock(&val, sizeof(val)); return val; }
+
+void StateReader::readBlock(void* data, const size_t size)
+{
+	if (!_valid || size > _buffer.size() - _offset)
+	{
+		_valid = false;
+		memset(data, 0, size);
+		return;
+	}
+
+	memcpy(data, &_buffer[_offset], size);
+	_offset += size;
+}
+
+bool StateReader::isValid() const { return _valid; }
+bool StateReader::isAtEnd() const { return _offset == _buffer.size(); }
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "common.h"
+
+#include <cstddef>
+#include <vector>
+
+// Flat little helpers for the binary save state format. Values are stored with fixed widths in
+// host byte order, so a state is only meant to be loaded by a build for the same architecture.
+
+class StateWriter final
+{
+public:
+	StateWriter(std::vector<byte>& buffer);
+
+	void writeByte(const byte val);
+	void writeWord(const word val);
+	void writeDword(const dword val);
+	void writeCycle(const cycle_t val);
+	void writeBlock(const void* data, const size_t size);
+
+private:
+	std::vector<byte>& _buffer;
+};
+
+class StateReader final
+{
+public:
+	StateReader(const std::vector<byte>& buffer);
+
+	byte readByte();
+	word readWord();
+	dword readDword();
+	cycle_t readCycle();
+	void readBlock(void* data, const size_t size);
+
+	// Reads past the end leave the destination zeroed and latch this to false
+	bool isValid() const;
+	bool isAtEnd() const;
+
+private:
+	const std::vector<byte>& _buffer;
+	size_t                   _offset;
+	bool                     _valid;
+};
\ No newline at end of file
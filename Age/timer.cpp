@@ -0,0 +1,154 @@
+#include "timer.h"
+#include "memory.h"
+#include "scheduler.h"
+#include "state.h"
+
+static const byte TIMER_CONTROL_FLAG_ENABLE = 0x04;
+
+// TIMA input clocks in cycles, indexed by the low two bits of TAC (4K, 256K, 64K, 16K)
+static const cycle_t s_timerPeriods[4] = { 1024, 16, 64, 256 };
+
+Timer::Timer(Scheduler& scheduler)
+	: _memory(nullptr)
+	, _scheduler(scheduler)
+{
+	_scheduler.setHandler(Scheduler::EVENT_TIMER, [this](const cycle_t)
+	{
+		syncTima();
+		scheduleOverflow();
+	});
+
+	resetTimer();
+}
+
+void Timer::resetTimer()
+{
+	_divBase  = _scheduler.getNow();
+	_timaSync = _divBase;
+	_tima     = 0;
+	_tma      = 0;
+	_tac      = 0;
+
+	_scheduler.cancel(Scheduler::EVENT_TIMER);
+}
+
+void Timer::serialize(StateWriter& writer) const
+{
+	writer.writeCycle(_divBase);
+	writer.writeCycle(_timaSync);
+	writer.writeByte(_tima);
+	writer.writeByte(_tma);
+	writer.writeByte(_tac);
+}
+
+void Timer::deserialize(StateReader& reader)
+{
+	// The pending overflow comes back with the scheduler deadlines, so nothing is rescheduled here
+	_divBase  = reader.readCycle();
+	_timaSync = reader.readCycle();
+	_tima     = reader.readByte();
+	_tma      = reader.readByte();
+	_tac      = reader.readByte();
+}
+
+void Timer::setMemory(Memory* const memory)
+{
+	_memory = memory;
+}
+
+byte Timer::readByte(const word addr)
+{
+	switch (addr)
+	{
+		// DIV is the upper byte of the free running cycle counter, so it is derived on demand
+		case 0xFF04: return static_cast<byte>((_scheduler.getNow() - _divBase) >> 8);
+		case 0xFF05: syncTima(); return _tima;
+		case 0xFF06: return _tma;
+		case 0xFF07: return _tac;
+	}
+
+	return 0;
+}
+
+void Timer::writeByte(const word addr, const byte val)
+{
+	switch (addr)
+	{
+		case 0xFF04:
+		{
+			syncTima();
+			_divBase  = _scheduler.getNow();
+			_timaSync = _divBase;
+			scheduleOverflow();
+		} break;
+
+		case 0xFF05:
+		{
+			syncTima();
+			_tima = val;
+			scheduleOverflow();
+		} break;
+
+		case 0xFF06: _tma = val; break;
+
+		case 0xFF07:
+		{
+			syncTima();
+			_tac = val;
+			scheduleOverflow();
+		} break;
+	}
+}
+
+bool Timer::isTimerEnabled() const
+{
+	return (_tac & TIMER_CONTROL_FLAG_ENABLE) != 0;
+}
+
+cycle_t Timer::getTimerPeriod() const
+{
+	return s_timerPeriods[_tac & 0x3];
+}
+
+void Timer::syncTima()
+{
+	const cycle_t now = _scheduler.getNow();
+
+	if (isTimerEnabled())
+	{
+		// TIMA ticks whenever the divider counter crosses a multiple of the selected period
+		const cycle_t period = getTimerPeriod();
+		cycle_t ticks = (now - _divBase) / period - (_timaSync - _divBase) / period;
+
+		while (ticks > 0)
+		{
+			const cycle_t ticksToOverflow = 0x100 - _tima;
+
+			if (ticks < ticksToOverflow)
+			{
+				_tima += static_cast<byte>(ticks);
+				break;
+			}
+
+			ticks -= ticksToOverflow;
+			_tima = _tma;
+			_memory->requestInterrupt(Memory::INTERRUPT_FLAG_TIMER);
+		}
+	}
+
+	_timaSync = now;
+}
+
+void Timer::scheduleOverflow()
+{
+	if (!isTimerEnabled())
+	{
+		_scheduler.cancel(Scheduler::EVENT_TIMER);
+		return;
+	}
+
+	const cycle_t period   = getTimerPeriod();
+	const cycle_t nextTick = (_timaSync - _divBase) / period + (0x100 - _tima);
+
+	_scheduler.schedule(Scheduler::EVENT_TIMER, _divBase + nextTick * period);
+}
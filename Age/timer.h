@@ -0,0 +1,38 @@
+#pragma once
+
+#include "common.h"
+
+class Memory;
+class Scheduler;
+class StateReader;
+class StateWriter;
+class Timer final
+{
+public:
+	Timer(Scheduler&);
+
+	void resetTimer();
+
+	void setMemory(Memory* const memory);
+
+	byte readByte(const word addr);
+	void writeByte(const word addr, const byte val);
+
+	void serialize(StateWriter& writer) const;
+	void deserialize(StateReader& reader);
+
+private:
+	bool isTimerEnabled() const;
+	cycle_t getTimerPeriod() const;
+	void syncTima();
+	void scheduleOverflow();
+
+private:
+	cycle_t    _divBase;
+	cycle_t    _timaSync;
+	byte       _tima;
+	byte       _tma;
+	byte       _tac;
+	Memory*    _memory;
+	Scheduler& _scheduler;
+};
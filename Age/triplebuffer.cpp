@@ -0,0 +1,36 @@
+#include "triplebuffer.h"
+
+#include <cstring>
+
+TripleBuffer::TripleBuffer()
+	: _middle(1)
+	, _write(0)
+	, _read(2)
+{
+	memset(_frames, 0, sizeof(_frames));
+}
+
+display_frame& TripleBuffer::getWriteFrame()
+{
+	return _frames[_write];
+}
+
+void TripleBuffer::publish()
+{
+	// Hand the finished frame over and take whatever was in the middle to write the next one
+	_write = _middle.exchange(_write | FRESH_FLAG, std::memory_order_acq_rel) & INDEX_MASK;
+}
+
+bool TripleBuffer::acquire()
+{
+	if ((_middle.load(std::memory_order_acquire) & FRESH_FLAG) == 0)
+		return false;
+
+	_read = _middle.exchange(_read, std::memory_order_acq_rel) & INDEX_MASK;
+	return true;
+}
+
+const display_frame& TripleBuffer::getReadFrame() const
+{
+	return _frames[_read];
+}
\ No newline at end of file
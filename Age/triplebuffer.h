@@ -0,0 +1,41 @@
+#pragma once
+
+#include "common.h"
+#include "display.h"
+
+#include <atomic>
+
+struct display_frame
+{
+	byte gfx[Display::DISPLAY_COLS * Display::DISPLAY_ROWS * Display::DISPLAY_DEPTH];
+	byte tileGfx[Display::DISPLAY_TILE_VIEW_BASE_WIDTH * Display::DISPLAY_TILE_VIEW_BASE_HEIGHT * Display::DISPLAY_DEPTH];
+	byte spriteGfx[Display::DISPLAY_SPRITE_VIEW_BASE_WIDTH * Display::DISPLAY_SPRITE_VIEW_BASE_HEIGHT * Display::DISPLAY_DEPTH];
+};
+
+// Lock free hand over of finished frames from one producer thread to one consumer thread.
+// The producer always has a frame to write into and the consumer always has one to read from,
+// the third sits in between and is swapped atomically, so neither side ever waits on the other.
+// Frames the consumer did not get to in time are simply overwritten by newer ones.
+class TripleBuffer final
+{
+public:
+	TripleBuffer();
+
+	// Producer side
+	display_frame& getWriteFrame();
+	void publish();
+
+	// Consumer side, acquire returns false when nothing newer has been published
+	bool acquire();
+	const display_frame& getReadFrame() const;
+
+private:
+	static const byte INDEX_MASK = 0x03;
+	static const byte FRESH_FLAG = 0x04;
+
+private:
+	display_frame     _frames[3];
+	std::atomic<byte> _middle;
+	byte              _write;
+	byte              _read;
+};
\ No newline at end of file
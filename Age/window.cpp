@@ -14,6 +14,8 @@ Window::Window(
 	, _originalWidth(width)
 	, _originalHeight(height)
 	, _currTexture(nullptr)
+	, _textureWidth(0)
+	, _textureHeight(0)
 {
 	_windowHandle   = SDL_CreateWindow(title.c_str(), x, y, width, height, 0);
 	_rendererHandle = SDL_CreateRenderer(_windowHandle, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
@@ -24,6 +26,7 @@ Window::Window(
 
 Window::~Window()
 {
+	SDL_DestroyTexture(_currTexture);
 	SDL_DestroyRenderer(_rendererHandle);
 	SDL_DestroyWindow(_windowHandle);
 }
@@ -50,10 +53,19 @@ int Window::getID() const { return _id; }
 SDL_Renderer* Window::getRendererHandle() const { return _rendererHandle; }
 SDL_Window* Window::getWindowHandle() const { return _windowHandle; }
 
-void Window::setTextureFromSurface(SDL_Surface* surface)
+void Window::updateTexture(const byte* pixels, const word width, const word height)
 {
-	SDL_DestroyTexture(_currTexture);
-	_currTexture = SDL_CreateTextureFromSurface(_rendererHandle, surface);
+	// The texture lives as long as the view keeps its size and is rewritten in place every frame.
+	// ABGR8888 is R, G, B, A in memory on little endian hosts, the byte order the display writes
+	if (!_currTexture || width != _textureWidth || height != _textureHeight)
+	{
+		SDL_DestroyTexture(_currTexture);
+		_currTexture   = SDL_CreateTexture(_rendererHandle, SDL_PIXELFORMAT_ABGR8888, SDL_TEXTUREACCESS_STREAMING, width, height);
+		_textureWidth  = width;
+		_textureHeight = height;
+	}
+
+	SDL_UpdateTexture(_currTexture, nullptr, pixels, width * 4);
 }
 
 void Window::render()
@@ -6,7 +6,6 @@
 
 struct SDL_Window;
 struct SDL_Renderer;
-struct SDL_Surface;
 struct SDL_Texture;
 union SDL_Event;
 class Window
@@ -31,7 +30,7 @@ public:
 
 	void handleEvent(const SDL_Event& e);
 	void render();
-	void setTextureFromSurface(SDL_Surface* surface);
+	void updateTexture(const byte* pixels, const word width, const word height);
 
 private:
 
@@ -43,4 +42,6 @@ private:
 	SDL_Window* _windowHandle;
 	SDL_Renderer* _rendererHandle;
 	SDL_Texture* _currTexture;
+	word _textureWidth;
+	word _textureHeight;
 };
@@ -0,0 +1,365 @@
+#include "common.h"
+#include "emulator.h"
+#include "pixels.h"
+#include "profile.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+
+static const char* FRAMES_FLAG = "-frames";
+static const char* JSON_FLAG   = "-json";
+static const char* KERNEL_FLAG = "-kernel";
+static const char* JIT_FLAG    = "-jit";
+
+static const unsigned long long DEFAULT_FRAME_COUNT = 1200;
+static const unsigned long long WARMUP_FRAME_COUNT  = 60;
+
+static const word ROM_SIZE      = 0x8000;
+static const word PROGRAM_START = 0x0150;
+
+struct workload
+{
+	std::string       name;
+	std::vector<char> rom;
+};
+
+struct workload_result
+{
+	std::string   name;
+	cycle_t       cycles;
+	double        seconds;
+	profile_stats stats;
+};
+
+std::vector<char> buildRom(const std::vector<byte>& program)
+{
+	std::vector<char> rom(ROM_SIZE, 0);
+
+	// Entry point jumps over the header, every interrupt vector just returns
+	const byte entry[] = { 0x00, 0xC3, PROGRAM_START & 0xFF, PROGRAM_START >> 8 };
+	memcpy(&rom[0x0100], entry, sizeof(entry));
+
+	for (word vector = 0x40; vector <= 0x60; vector += 8)
+		rom[vector] = static_cast<char>(0xD9);
+
+	strcpy(&rom[0x0134], "AGEBENCH");
+	memcpy(&rom[PROGRAM_START], &program[0], program.size());
+	return rom;
+}
+
+// Tight ALU loop over a page of WRAM with the background on
+std::vector<char> buildAluWorkload()
+{
+	return buildRom(
+	{
+		0x21, 0x00, 0xC0, // loop:  LD HL,0xC000
+		0x06, 0x00,       //        LD B,0
+		0x7E,             // inner: LD A,(HL)
+		0x80,             //        ADD A,B
+		0xEE, 0x5A,       //        XOR 0x5A
+		0x22,             //        LD (HL+),A
+		0x07,             //        RLCA
+		0x05,             //        DEC B
+		0x20, 0xF7,       //        JR NZ,inner
+		0x18, 0xF0        //        JR loop
+	});
+}
+
+// Patterned tiles and sprites, background and sprites on, scrolling diagonally
+std::vector<char> buildScrollWorkload()
+{
+	return buildRom(
+	{
+		0x21, 0x00, 0x80, //        LD HL,0x8000
+		0x7D,             // vram:  LD A,L
+		0xAC,             //        XOR H
+		0x22,             //        LD (HL+),A
+		0x7C,             //        LD A,H
+		0xFE, 0xA0,       //        CP 0xA0
+		0x20, 0xF8,       //        JR NZ,vram
+		0x21, 0x00, 0xFE, //        LD HL,0xFE00
+		0x7D,             // oam:   LD A,L
+		0x07,             //        RLCA
+		0x85,             //        ADD A,L
+		0x22,             //        LD (HL+),A
+		0x7D,             //        LD A,L
+		0xFE, 0xA0,       //        CP 0xA0
+		0x20, 0xF7,       //        JR NZ,oam
+		0x3E, 0x93,       //        LD A,0x93
+		0xE0, 0x40,       //        LDH (0x40),A
+		0xF0, 0x43,       // loop:  LDH A,(0x43)
+		0x3C,             //        INC A
+		0xE0, 0x43,       //        LDH (0x43),A
+		0xF0, 0x42,       //        LDH A,(0x42)
+		0x3D,             //        DEC A
+		0xE0, 0x42,       //        LDH (0x42),A
+		0x06, 0x00,       //        LD B,0
+		0x05,             // wait:  DEC B
+		0x20, 0xFD,       //        JR NZ,wait
+		0x18, 0xEF        //        JR loop
+	});
+}
+
+// A game waiting for vblank in HALT, which is what most titles do most of the time
+std::vector<char> buildIdleWorkload()
+{
+	return buildRom(
+	{
+		0x3E, 0x01,       //        LD A,0x01
+		0xE0, 0xFF,       //        LDH (0xFF),A
+		0xFB,             //        EI
+		0x76,             // loop:  HALT
+		0x18, 0xFD        //        JR loop
+	});
+}
+
+// A game spinning on LY until vblank, the other common way of waiting for the next frame
+std::vector<char> buildPollWorkload()
+{
+	return buildRom(
+	{
+		0xF0, 0x44,       // loop:  LDH A,(0x44)
+		0xFE, 0x90,       //        CP 0x90
+		0x20, 0xFA,       //        JR NZ,loop
+		0xF0, 0x44,       // wait:  LDH A,(0x44)
+		0xFE, 0x90,       //        CP 0x90
+		0x28, 0xFA,       //        JR Z,wait
+		0x18, 0xF2        //        JR loop
+	});
+}
+
+bool loadRomFile(const char* const path, std::vector<char>& romData)
+{
+	std::ifstream file(path, std::ios::binary|std::ios::ate);
+	if (!file.is_open())
+		return false;
+
+	std::ifstream::pos_type pos = file.tellg();
+	romData.resize(static_cast<size_t>(pos));
+
+	file.seekg(0, std::ios::beg);
+	file.read(&romData[0], pos);
+	return true;
+}
+
+workload_result runWorkload(const workload& work, const unsigned long long frames, const bool useJit)
+{
+	Emulator emulator([](byte*) {});
+	emulator.setSkipBios(true);
+	emulator.setJitEnabled(useJit);
+	emulator.loadRom(work.rom);
+
+	for (unsigned long long i = 0; i < WARMUP_FRAME_COUNT; ++i)
+		emulator.runFrame();
+
+	resetProfileStats();
+
+	workload_result result;
+	result.name   = work.name;
+	result.cycles = 0;
+
+	const auto start = std::chrono::high_resolution_clock::now();
+
+	for (unsigned long long i = 0; i < frames; ++i)
+		result.cycles += emulator.runFrame();
+
+	const auto end = std::chrono::high_resolution_clock::now();
+
+	result.seconds = std::chrono::duration<double>(end - start).count();
+	result.stats   = getProfileStats();
+	return result;
+}
+
+double perUnit(const double nanoseconds, const cycle_t units)
+{
+	return units > 0 ? nanoseconds / units : 0.0;
+}
+
+std::string escapeJson(const std::string& text)
+{
+	std::string escaped;
+	for (const char c: text)
+	{
+		if (c == '"' || c == '\\')
+			escaped += '\\';
+		escaped += c;
+	}
+	return escaped;
+}
+
+void writeJson(std::ostream& out, const std::vector<workload_result>& results, const unsigned long long frames, const bool useJit)
+{
+	out << "{" << std::endl;
+	out << "  \"pixel_kernel\": \"" << getPixelKernelName(getPixelKernel()) << "\"," << std::endl;
+	out << "  \"jit\": " << (useJit ? "true" : "false") << "," << std::endl;
+	out << "  \"frames_per_workload\": " << frames << "," << std::endl;
+	out << "  \"workloads\": [" << std::endl;
+
+	for (size_t i = 0; i < results.size(); ++i)
+	{
+		const workload_result& result = results[i];
+		const profile_stats& stats    = result.stats;
+
+		const double totalNs  = result.seconds * 1e9;
+		const double eventsNs = static_cast<double>(stats.sectionNanoseconds[PS_EVENTS]);
+		const double cpuNs    = totalNs > eventsNs ? totalNs - eventsNs : 0.0;
+
+		out << "    {" << std::endl;
+		out << "      \"name\": \"" << escapeJson(result.name) << "\"," << std::endl;
+		out << "      \"frames\": " << stats.frames << "," << std::endl;
+		out << "      \"cycles\": " << result.cycles << "," << std::endl;
+		out << "      \"instructions\": " << stats.instructions << "," << std::endl;
+		out << "      \"translated_instructions\": " << stats.translatedInstructions << "," << std::endl;
+		out << "      \"halt_skips\": " << stats.haltSkips << "," << std::endl;
+		out << "      \"loop_skips\": " << stats.loopSkips << "," << std::endl;
+		out << "      \"scanlines\": " << stats.scanlines << "," << std::endl;
+		out << "      \"host_seconds\": " << result.seconds << "," << std::endl;
+		out << "      \"fps\": " << (result.seconds > 0.0 ? stats.frames / result.seconds : 0.0) << "," << std::endl;
+		out << "      \"ns_per_instruction\": " << perUnit(cpuNs, stats.instructions) << "," << std::endl;
+		out << "      \"ns_per_scanline\": " << perUnit(static_cast<double>(stats.sectionNanoseconds[PS_SCANLINE]), stats.scanlines) << "," << std::endl;
+		out << "      \"breakdown_ns\": {" << std::endl;
+		out << "        \"cpu\": " << cpuNs << "," << std::endl;
+		out << "        \"events\": " << eventsNs << "," << std::endl;
+		out << "        \"scanline\": " << stats.sectionNanoseconds[PS_SCANLINE] << "," << std::endl;
+		out << "        \"frame_output\": " << stats.sectionNanoseconds[PS_FRAME_OUTPUT] << std::endl;
+		out << "      }" << std::endl;
+		out << "    }" << (i + 1 < results.size() ? "," : "") << std::endl;
+	}
+
+	out << "  ]" << std::endl;
+	out << "}" << std::endl;
+}
+
+void printSummary(const std::vector<workload_result>& results)
+{
+	for (const workload_result& result: results)
+	{
+		const profile_stats& stats = result.stats;
+		const double totalNs       = result.seconds * 1e9;
+		const double eventsNs      = static_cast<double>(stats.sectionNanoseconds[PS_EVENTS]);
+
+		std::cout << result.name << std::endl;
+		std::cout << "  FPS: " << (result.seconds > 0.0 ? stats.frames / result.seconds : 0.0)
+		          << "    ns/instruction: " << perUnit(totalNs - eventsNs, stats.instructions)
+		          << "    ns/scanline: " << perUnit(static_cast<double>(stats.sectionNanoseconds[PS_SCANLINE]), stats.scanlines) << std::endl;
+		std::cout << "  cpu: " << (totalNs - eventsNs) / totalNs * 100.0 << "%"
+		          << "    scanlines: " << stats.sectionNanoseconds[PS_SCANLINE] / totalNs * 100.0 << "%"
+		          << "    frame output: " << stats.sectionNanoseconds[PS_FRAME_OUTPUT] / totalNs * 100.0 << "%" << std::endl;
+	}
+}
+
+void printUsage()
+{
+	std::cout << "Usage: AgeBench [rom...] [-frames N] [-json file] [-kernel scalar|sse2|avx2] [-jit]" << std::endl;
+	std::cout << "  rom...     extra roms to run after the built-in workloads" << std::endl;
+	std::cout << "  -frames N  frames to measure per workload (default " << DEFAULT_FRAME_COUNT << ")" << std::endl;
+	std::cout << "  -json file write the results as JSON to file, - for stdout" << std::endl;
+	std::cout << "  -kernel k  force a pixel expansion kernel (capped at what the host supports)" << std::endl;
+	std::cout << "  -jit       run hot code through the x86-64 translator" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned long long frames = DEFAULT_FRAME_COUNT;
+	const char* jsonPath      = nullptr;
+	bool useJit               = false;
+
+	std::vector<workload> workloads =
+	{
+		{ "builtin:alu",    buildAluWorkload() },
+		{ "builtin:scroll", buildScrollWorkload() },
+		{ "builtin:idle",   buildIdleWorkload() },
+		{ "builtin:poll",   buildPollWorkload() }
+	};
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strcmp(argv[i], FRAMES_FLAG) == 0 && i + 1 < argc)
+			frames = std::strtoull(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], JSON_FLAG) == 0 && i + 1 < argc)
+			jsonPath = argv[++i];
+		else if (strcmp(argv[i], KERNEL_FLAG) == 0 && i + 1 < argc)
+		{
+			const std::string kernel = argv[++i];
+			if (kernel == getPixelKernelName(PK_SCALAR))
+				setPixelKernel(PK_SCALAR);
+			else if (kernel == getPixelKernelName(PK_SSE2))
+				setPixelKernel(PK_SSE2);
+			else if (kernel == getPixelKernelName(PK_AVX2))
+				setPixelKernel(PK_AVX2);
+			else
+			{
+				printUsage();
+				return 1;
+			}
+		}
+		else if (strcmp(argv[i], JIT_FLAG) == 0)
+			useJit = true;
+		else if (argv[i][0] == '-')
+		{
+			printUsage();
+			return 1;
+		}
+		else
+		{
+			workload romWorkload;
+			romWorkload.name = argv[i];
+
+			if (!loadRomFile(argv[i], romWorkload.rom))
+			{
+				std::cout << "Could not open rom: " << argv[i] << std::endl;
+				return 1;
+			}
+
+			workloads.push_back(romWorkload);
+		}
+	}
+
+	if (frames == 0)
+	{
+		printUsage();
+		return 1;
+	}
+
+	if (useJit && !Emulator([](byte*) {}).setJitEnabled(true))
+	{
+		std::cout << "The jit is not supported on this host" << std::endl;
+		return 1;
+	}
+
+	std::vector<workload_result> results;
+	for (const workload& work: workloads)
+		results.push_back(runWorkload(work, frames, useJit));
+
+	// The core logs unimplemented registers in hex, so make sure numbers come out in decimal
+	std::cout << std::dec;
+
+	if (jsonPath && strcmp(jsonPath, "-") == 0)
+	{
+		writeJson(std::cout, results, frames, useJit);
+		return 0;
+	}
+
+	printSummary(results);
+
+	if (jsonPath)
+	{
+		std::ofstream jsonFile(jsonPath);
+		if (!jsonFile.is_open())
+		{
+			std::cout << "Could not open json file: " << jsonPath << std::endl;
+			return 1;
+		}
+
+		jsonFile << std::dec;
+		writeJson(jsonFile, results, frames, useJit);
+	}
+
+	return 0;
+}
\ No newline at end of file
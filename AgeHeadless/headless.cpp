@@ -0,0 +1,222 @@
+#include "common.h"
+#include "batch.h"
+#include "emulator.h"
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+
+static const char* FRAMES_FLAG  = "-frames";
+static const char* CYCLES_FLAG  = "-cycles";
+static const char* DUMP_FLAG    = "-dump";
+static const char* SKIP_FLAG    = "-skipbios";
+static const char* LOAD_FLAG    = "-load";
+static const char* SAVE_FLAG    = "-save";
+static const char* THREADS_FLAG = "-threads";
+static const char* RENDER_FLAG  = "-render";
+static const char* JIT_FLAG     = "-jit";
+
+static const unsigned long long DEFAULT_FRAME_COUNT = 600;
+
+template<typename T>
+bool readFile(const char* const path, std::vector<T>& data)
+{
+	std::ifstream file(path, std::ios::binary|std::ios::ate);
+	if (!file.is_open())
+		return false;
+
+	std::ifstream::pos_type pos = file.tellg();
+	data.resize(static_cast<size_t>(pos));
+
+	file.seekg(0, std::ios::beg);
+	file.read(reinterpret_cast<char*>(data.data()), pos);
+	return true;
+}
+
+template<typename T>
+bool writeFile(const char* const path, const std::vector<T>& data)
+{
+	std::ofstream file(path, std::ios::binary);
+	if (!file.is_open())
+		return false;
+
+	file.write(reinterpret_cast<const char*>(data.data()), data.size());
+	return true;
+}
+
+void printUsage()
+{
+	std::cout << "Usage: AgeHeadless <rom> [rom...] [-frames N] [-cycles N] [-threads N] [-render N] [-skipbios] [-jit] [-dump file] [-load state] [-save state]" << std::endl;
+	std::cout << "  -frames N  stop after N frames have been emulated (default " << DEFAULT_FRAME_COUNT << ")" << std::endl;
+	std::cout << "  -cycles N  stop after N clock cycles have been emulated" << std::endl;
+	std::cout << "  -threads N run several roms on N threads (default one per hardware thread)" << std::endl;
+	std::cout << "  -render N  draw 1 of every N frames, 0 only draws the last one (default 1)" << std::endl;
+	std::cout << "  -skipbios  start the cart directly from the post-bios state" << std::endl;
+	std::cout << "  -jit       translate hot code to native x86-64 (falls back to the interpreter elsewhere)" << std::endl;
+	std::cout << "  -dump file write the last emulated frame as raw RGBA to file (single rom only)" << std::endl;
+	std::cout << "  -load file resume from a save state of the same cart (single rom only)" << std::endl;
+	std::cout << "  -save file write a save state once the run has finished (single rom only)" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+	std::vector<const char*> romPaths;
+
+	const char* dumpPath = nullptr;
+	const char* loadPath = nullptr;
+	const char* savePath = nullptr;
+	bool skipBios        = false;
+	bool useJit          = false;
+
+	unsigned long long maxFrames = 0;
+	unsigned long long maxCycles = 0;
+	unsigned int threadCount     = 0;
+	dword renderInterval         = 1;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strcmp(argv[i], FRAMES_FLAG) == 0 && i + 1 < argc)
+			maxFrames = std::strtoull(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], CYCLES_FLAG) == 0 && i + 1 < argc)
+			maxCycles = std::strtoull(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], THREADS_FLAG) == 0 && i + 1 < argc)
+			threadCount = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+		else if (strcmp(argv[i], RENDER_FLAG) == 0 && i + 1 < argc)
+			renderInterval = static_cast<dword>(std::strtoul(argv[++i], nullptr, 10));
+		else if (strcmp(argv[i], DUMP_FLAG) == 0 && i + 1 < argc)
+			dumpPath = argv[++i];
+		else if (strcmp(argv[i], SKIP_FLAG) == 0)
+			skipBios = true;
+		else if (strcmp(argv[i], JIT_FLAG) == 0)
+			useJit = true;
+		else if (strcmp(argv[i], LOAD_FLAG) == 0 && i + 1 < argc)
+			loadPath = argv[++i];
+		else if (strcmp(argv[i], SAVE_FLAG) == 0 && i + 1 < argc)
+			savePath = argv[++i];
+		else if (argv[i][0] != '-')
+			romPaths.push_back(argv[i]);
+		else
+		{
+			printUsage();
+			return 1;
+		}
+	}
+
+	// Dumps and states name a single file, so they only make sense for a single rom
+	if (romPaths.empty() || (romPaths.size() > 1 && (dumpPath || loadPath || savePath)))
+	{
+		printUsage();
+		return 1;
+	}
+
+	if (maxFrames == 0 && maxCycles == 0)
+		maxFrames = DEFAULT_FRAME_COUNT;
+
+	std::vector<byte> capturedFrame;
+	std::vector<byte> loadedState;
+	std::vector<byte> savedState;
+	std::vector<std::string> cartNames(romPaths.size());
+
+	if (dumpPath)
+		capturedFrame.resize(Display::DISPLAY_COLS * Display::DISPLAY_ROWS * Display::DISPLAY_DEPTH);
+
+	if (loadPath && !readFile(loadPath, loadedState))
+	{
+		std::cout << "Could not open state: " << loadPath << std::endl;
+		return 1;
+	}
+
+	std::vector<batch_job> jobs(romPaths.size());
+
+	for (size_t i = 0; i < romPaths.size(); ++i)
+	{
+		batch_job& job = jobs[i];
+		job.name           = romPaths[i];
+		job.skipBios       = skipBios;
+		job.useJit         = useJit;
+		job.frames         = maxFrames;
+		job.cycles         = maxCycles;
+		job.renderInterval = renderInterval;
+
+		if (!readFile(romPaths[i], job.rom))
+		{
+			std::cout << "Could not open rom: " << romPaths[i] << std::endl;
+			return 1;
+		}
+
+		if (dumpPath)
+		{
+			job.fillDisplayCallback = [&capturedFrame](byte* gfxData)
+			{
+				memcpy(&capturedFrame[0], gfxData, capturedFrame.size());
+			};
+		}
+
+		if (loadPath)
+			job.onStart = [&loadedState](Emulator& emulator) { return emulator.loadState(loadedState); };
+
+		std::string& cartName = cartNames[i];
+		job.onFinish = [&cartName, &savedState, savePath](Emulator& emulator)
+		{
+			cartName = emulator.getMemory().getCartName();
+
+			if (savePath)
+				emulator.saveState(savedState);
+		};
+	}
+
+	BatchRunner runner(romPaths.size() > 1 ? threadCount : 1);
+
+	const auto start = std::chrono::high_resolution_clock::now();
+	const std::vector<batch_result> results = runner.run(jobs);
+	const auto end = std::chrono::high_resolution_clock::now();
+
+	std::cout << std::dec;
+
+	unsigned long long totalFrames = 0;
+
+	for (size_t i = 0; i < results.size(); ++i)
+	{
+		const batch_result& result = results[i];
+
+		if (!result.completed)
+		{
+			if (loadPath)
+				std::cout << "Could not load state: " << loadPath << std::endl;
+			else
+				std::cout << "Could not run rom: " << result.name << std::endl;
+			return 1;
+		}
+
+		std::cout << "Cart: " << cartNames[i] << std::endl;
+		std::cout << "Frames: " << result.frames << "    Cycles: " << result.cycles << std::endl;
+		std::cout << "Host time: " << result.seconds << "s    FPS: " << (result.seconds > 0.0 ? result.frames / result.seconds : 0.0) << std::endl;
+
+		totalFrames += result.frames;
+	}
+
+	if (results.size() > 1)
+	{
+		const double seconds = std::chrono::duration<double>(end - start).count();
+
+		std::cout << "Total: " << results.size() << " roms on " << runner.getThreadCount() << " threads" << std::endl;
+		std::cout << "Wall time: " << seconds << "s    Aggregate FPS: " << (seconds > 0.0 ? totalFrames / seconds : 0.0) << std::endl;
+	}
+
+	if (dumpPath && !writeFile(dumpPath, capturedFrame))
+	{
+		std::cout << "Could not open dump file: " << dumpPath << std::endl;
+		return 1;
+	}
+
+	if (savePath && !writeFile(savePath, savedState))
+	{
+		std::cout << "Could not open save state file: " << savePath << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
\ No newline at end of file